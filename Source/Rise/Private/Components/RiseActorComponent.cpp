@@ -3,4 +3,12 @@
 void URiseActorComponent::AddGameplayTags(FGameplayTagContainer& TagContainer)
 {
 	TagContainer.AppendTags(InitialGameplayTags);
-}
\ No newline at end of file
+}
+
+void URiseActorComponent::OnReleasedToPool()
+{
+}
+
+void URiseActorComponent::OnAcquiredFromPool()
+{
+}
@@ -3,12 +3,17 @@
 #include "Net/UnrealNetwork.h"
 
 #include "RisePlayerState.h"
+#include "Subsystems/RiseOwnershipSubsystem.h"
 
 URiseOwnableComponent::URiseOwnableComponent()
 {
 	SetIsReplicatedByDefault(true);
 
 	InitialOwnerPlayerIndex = ARisePlayerState::PLAYER_INDEX_NONE;
+	bIsStructure = false;
+	OwnershipSetIndex = ARisePlayerState::PLAYER_INDEX_NONE;
+	OwnershipSlot = INDEX_NONE;
+	InitialOwnerSlot = INDEX_NONE;
 }
 
 void URiseOwnableComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -18,11 +23,71 @@ void URiseOwnableComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>
 	DOREPLIFETIME(URiseOwnableComponent, Owner);
 }
 
+void URiseOwnableComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Registration happens as the level loads, before players are restarted, so the
+	// game mode can find the actors each player starts with without scanning the world.
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->RegisterInitialOwnable(this);
+	}
+}
+
+void URiseOwnableComponent::OnUnregister()
+{
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->UnregisterInitialOwnable(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void URiseOwnableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Actors may already be owned before play begins (placed or replicated with an owner).
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->UpdateOwnable(this);
+	}
+}
+
+void URiseOwnableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->UnregisterOwnable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void URiseOwnableComponent::OnReleasedToPool()
+{
+	Super::OnReleasedToPool();
+
+	// Pooled actors belong to nobody. Clearing the owner also removes the actor from the ownership index.
+	SetPlayerOwnerByPlayerState(nullptr);
+}
+
 ARisePlayerState* URiseOwnableComponent::GetPlayerOwner() const
 {
 	return Owner;
 }
 
+bool URiseOwnableComponent::IsStructure() const
+{
+	return bIsStructure;
+}
+
 void URiseOwnableComponent::SetPlayerOwnerByController(AController* NewOwner)
 {
 	if (!IsValid(NewOwner))
@@ -36,13 +101,18 @@ void URiseOwnableComponent::SetPlayerOwnerByController(AController* NewOwner)
 }
 
 void URiseOwnableComponent::SetPlayerOwnerByPlayerState(ARisePlayerState* NewOwner)
+{
+	SetPlayerOwnerByPlayerState(NewOwner, false);
+}
+
+void URiseOwnableComponent::SetPlayerOwnerByPlayerState(ARisePlayerState* NewOwner, bool bSuppressPlayerNotification)
 {
 	ARisePlayerState* OldOwner = Owner;
 	Owner = NewOwner;
 
 	if (OldOwner != NewOwner)
 	{
-		NotifyOwnerChanged(OldOwner, NewOwner);
+		NotifyOwnerChanged(OldOwner, NewOwner, bSuppressPlayerNotification);
 	}
 }
 
@@ -80,25 +150,32 @@ uint8 URiseOwnableComponent::GetInitialOwnerPlayerIndex() const
 
 void URiseOwnableComponent::OnOwnerChangedCallback(ARisePlayerState* OldOwner)
 {
-	NotifyOwnerChanged(OldOwner, Owner);
+	NotifyOwnerChanged(OldOwner, Owner, false);
 }
 
-void URiseOwnableComponent::NotifyOwnerChanged(ARisePlayerState* OldOwner, ARisePlayerState* NewOwner)
+void URiseOwnableComponent::NotifyOwnerChanged(ARisePlayerState* OldOwner, ARisePlayerState* NewOwner, bool bSuppressPlayerNotification)
 {
 	OnOwnerChanged(GetOwner(), NewOwner ? Cast<AController>(NewOwner->GetOwner()) : nullptr);
 
-	UWorld* World = GetWorld();
-	if (IsValid(World))
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->UpdateOwnable(this);
+	}
+
+	if (bSuppressPlayerNotification)
+	{
+		return;
+	}
+
+	// Only the old and new owners care about this change, so notify them directly.
+	if (IsValid(OldOwner))
+	{
+		OldOwner->NotifyActorOwnershipChanged(GetOwner(), OldOwner, NewOwner);
+	}
+
+	if (IsValid(NewOwner))
 	{
-		for (FConstControllerIterator ControllerIt = World->GetControllerIterator(); ControllerIt; ++ControllerIt)
-		{
-			TWeakObjectPtr<AController> Controller = *ControllerIt;
-			ARisePlayerState* PlayerState = Controller->GetPlayerState<ARisePlayerState>();
-
-			if (IsValid(PlayerState) && (PlayerState == OldOwner || PlayerState == NewOwner))
-			{
-				PlayerState->NotifyActorOwnershipChanged(GetOwner(), OldOwner, NewOwner);
-			}
-		}
+		NewOwner->NotifyActorOwnershipChanged(GetOwner(), OldOwner, NewOwner);
 	}
 }
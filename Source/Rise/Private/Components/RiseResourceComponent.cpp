@@ -3,21 +3,42 @@
 #include "Net/UnrealNetwork.h"
 
 #include "RiseMacros.h"
+#include "RiseResourceField.h"
+#include "Subsystems/RiseActorPoolSubsystem.h"
+#include "Subsystems/RiseEconomySubsystem.h"
+#include "Subsystems/RiseResourceNodeIndexSubsystem.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+/**
+ * The estimated size of an amount update: the replicated units, the property handle and the header
+ * of the bunch sent when the owning actor is woken from dormancy.
+ */
+static constexpr int32 EstimatedAmountUpdateBytes = sizeof(uint16) + 1 + 8;
 
 URiseResourceComponent::URiseResourceComponent()
 {
 	SetIsReplicatedByDefault(true);
 
-	CurrentResourceAmount = 100;
-	MaxResourceAmount = CurrentResourceAmount;
+	MaxResourceAmount = 100;
+	CurrentResourceAmount = FRiseResourceMath::FromUnits(MaxResourceAmount);
+	ReplicatedResourceUnits = static_cast<uint16>(MaxResourceAmount);
 	ResourceMultiplier = 1.f;
+	FixedResourceMultiplier = RISE_RESOURCE_AMOUNT_ONE;
+	RegrowthDelay = 0.f;
+	bRegrowthEnabled = true;
+	bAwaitingRegrowth = false;
+	RegrowthTimeRemaining = 0.f;
+	ResourceId = RISE_RESOURCE_ID_NONE;
+	NodeIndexCell = FIntPoint::ZeroValue;
+	NodeIndexSlot = INDEX_NONE;
+	ResourceFieldInstance = INDEX_NONE;
 }
 
 void URiseResourceComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(URiseResourceComponent, CurrentResourceAmount);
+	DOREPLIFETIME(URiseResourceComponent, ReplicatedResourceUnits);
 }
 
 void URiseResourceComponent::BeginPlay()
@@ -29,14 +50,92 @@ void URiseResourceComponent::BeginPlay()
 		RISE_ERRORF(TEXT("No resource class assigned to %s."), *GetName());
 	}
 
+	// Convert authored values once, so the simulation never touches floats.
+	FixedResourceMultiplier = FRiseResourceMath::FromFloat(ResourceMultiplier);
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		CurrentResourceAmount = FRiseResourceMath::FromUnits(MaxResourceAmount);
+		UpdateReplicatedAmount();
+
+		// Resource nodes only send updates when they are harvested.
+		GetOwner()->SetNetDormancy(DORM_DormantAll);
+	}
+
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+	ResourceId = ResourceRegistry ? ResourceRegistry->GetResourceId(ResourceClass) : RISE_RESOURCE_ID_NONE;
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->RegisterResourceNode(this);
+	}
+
 	//TODO: We may want to do some deeper validation in here.
 }
 
+void URiseResourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->UnregisterResourceNode(this);
+	}
+
+	CancelRegrowth();
+	ReturnToResourceField();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void URiseResourceComponent::OnReleasedToPool()
+{
+	Super::OnReleasedToPool();
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->UnregisterResourceNode(this);
+	}
+
+	CancelRegrowth();
+	ReturnToResourceField();
+
+	// Let clients see the actor being put away.
+	GetOwner()->FlushNetDormancy();
+}
+
+void URiseResourceComponent::OnAcquiredFromPool()
+{
+	Super::OnAcquiredFromPool();
+
+	// A recycled node starts full again.
+	CurrentResourceAmount = FRiseResourceMath::FromUnits(MaxResourceAmount);
+	PendingExtractions.Reset();
+	bAwaitingRegrowth = false;
+	RegrowthTimeRemaining = 0.f;
+
+	// The actor has moved and reappeared, so always send an update.
+	UpdateReplicatedAmount();
+	GetOwner()->FlushNetDormancy();
+
+	// The node has been moved to its new location by now.
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->RegisterResourceNode(this);
+	}
+}
+
 TSubclassOf<URiseResource> URiseResourceComponent::GetResourceType() const
 {
 	return ResourceClass;
 }
 
+FRiseResourceId URiseResourceComponent::GetResourceId() const
+{
+	return ResourceId;
+}
+
 int32 URiseResourceComponent::GetMaxResourceAmount() const
 {
 	return MaxResourceAmount;
@@ -44,44 +143,139 @@ int32 URiseResourceComponent::GetMaxResourceAmount() const
 
 int32 URiseResourceComponent::GetCurrentResourceAmount() const
 {
-	return CurrentResourceAmount;
+	// Round up the same way as the replicated amount, so servers and clients agree.
+	return FRiseResourceMath::ToUnits(GetFixedResourceAmount() + RISE_RESOURCE_AMOUNT_ONE - 1);
 }
 
-int32 URiseResourceComponent::Extract(AActor* Gatherer, int32 DesiredAmount)
+FRiseResourceAmount URiseResourceComponent::GetFixedResourceAmount() const
 {
-	if (!Gatherer)
+	if (GetOwnerRole() == ROLE_Authority)
 	{
-		return 0;
+		return CurrentResourceAmount;
 	}
 
-	int32 ModifiedDesiredAmount = FMath::Floor(FMath::Clamp(DesiredAmount, 0, DesiredAmount) * ResourceMultiplier);
-	ModifiedDesiredAmount = FMath::Min(ModifiedDesiredAmount, CurrentResourceAmount);
+	return FRiseResourceMath::FromUnits(ReplicatedResourceUnits);
+}
+
+float URiseResourceComponent::Extract(AActor* Gatherer, int32 DesiredAmount)
+{
+	if (!Gatherer)
+	{
+		return 0.f;
+	}
 
-	int32 OldResourceAmount = CurrentResourceAmount;
-	int32 NewResourceAmount = CurrentResourceAmount -= ModifiedDesiredAmount;
+	FRiseResourceAmount OldResourceAmount = CurrentResourceAmount;
+	FRiseResourceAmount GatheredAmount = Withdraw(UnitsToWithdraw(DesiredAmount));
 
-	UE_LOG(LogRise, Log, TEXT("%s gathered %d %s from %s (%i -> %i)"),
+	UE_LOG(LogRise, Log, TEXT("%s gathered %.2f %s from %s (%.2f -> %.2f)"),
 		*Gatherer->GetName(),
-		ModifiedDesiredAmount,
+		FRiseResourceMath::ToFloat(GatheredAmount),
 		*ResourceClass->GetName(),
 		*GetOwner()->GetName(),
-		OldResourceAmount,
-		NewResourceAmount);
+		FRiseResourceMath::ToFloat(OldResourceAmount),
+		FRiseResourceMath::ToFloat(CurrentResourceAmount));
 
-	AActor* Owner = GetOwner();
+	UpdateReplicatedAmount();
 
-	OnResourceGathered.Broadcast(Gatherer, Owner, this, ModifiedDesiredAmount);
+	OnResourceGathered.Broadcast(Gatherer, GetOwner(), this, FRiseResourceMath::ToFloat(GatheredAmount));
 
-	if (CurrentResourceAmount <= 0)
+	if (OldResourceAmount > 0 && CurrentResourceAmount <= 0)
 	{
-		UE_LOG(LogRise, Log, TEXT("%s resource node has been depleted."), *Owner->GetName());
+		NotifyDepleted();
+	}
 
-		OnResourceDepleted.Broadcast(Owner, this);
+	return FRiseResourceMath::ToFloat(GatheredAmount);
+}
 
-		Owner->Destroy();
+void URiseResourceComponent::QueueExtract(AActor* Gatherer, int32 DesiredAmount)
+{
+	// Only the server resolves extractions. Requests made on clients would never be processed.
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		return;
 	}
 
-	return ModifiedDesiredAmount;
+	if (!Gatherer || DesiredAmount <= 0 || CurrentResourceAmount <= 0)
+	{
+		return;
+	}
+
+	URiseEconomySubsystem* EconomySubsystem = UWorld::GetSubsystem<URiseEconomySubsystem>(GetWorld());
+	if (!EconomySubsystem)
+	{
+		// Without an economy there is nothing to batch against.
+		Extract(Gatherer, DesiredAmount);
+		return;
+	}
+
+	if (PendingExtractions.IsEmpty())
+	{
+		EconomySubsystem->QueueResourceNode(this);
+	}
+
+	FRiseResourceExtractRequest& Request = PendingExtractions.AddDefaulted_GetRef();
+	Request.Gatherer = Gatherer;
+	Request.DesiredAmount = UnitsToWithdraw(DesiredAmount);
+}
+
+TArray<FRiseResourceGatherResult> URiseResourceComponent::ResolvePendingExtractions()
+{
+	TArray<FRiseResourceGatherResult> GatherResults;
+
+	if (PendingExtractions.IsEmpty())
+	{
+		return GatherResults;
+	}
+
+	FRiseResourceAmount OldResourceAmount = CurrentResourceAmount;
+
+	GatherResults.Reserve(PendingExtractions.Num());
+
+	// Gatherers are served in the order they queued until the node runs dry.
+	for (const FRiseResourceExtractRequest& Request : PendingExtractions)
+	{
+		AActor* Gatherer = Request.Gatherer.Get();
+		if (!Gatherer || CurrentResourceAmount <= 0)
+		{
+			continue;
+		}
+
+		FRiseResourceAmount GatheredAmount = Withdraw(Request.DesiredAmount);
+		if (GatheredAmount <= 0)
+		{
+			continue;
+		}
+
+		FRiseResourceGatherResult& GatherResult = GatherResults.AddDefaulted_GetRef();
+		GatherResult.Gatherer = Gatherer;
+		GatherResult.GatheredAmount = FRiseResourceMath::ToFloat(GatheredAmount);
+		GatherResult.FixedGatheredAmount = GatheredAmount;
+	}
+
+	PendingExtractions.Reset();
+
+	UpdateReplicatedAmount();
+
+	UE_LOG(LogRise, Verbose, TEXT("%i gatherers gathered %.2f %s from %s (%.2f -> %.2f)"),
+		GatherResults.Num(),
+		FRiseResourceMath::ToFloat(OldResourceAmount - CurrentResourceAmount),
+		*ResourceClass->GetName(),
+		*GetOwner()->GetName(),
+		FRiseResourceMath::ToFloat(OldResourceAmount),
+		FRiseResourceMath::ToFloat(CurrentResourceAmount));
+
+	if (!GatherResults.IsEmpty())
+	{
+		OnResourceBatchGathered.Broadcast(GetOwner(), this, GatherResults);
+	}
+
+	// An immediate extraction may already have drained the node, in which case it was depleted then.
+	if (OldResourceAmount > 0 && CurrentResourceAmount <= 0)
+	{
+		NotifyDepleted();
+	}
+
+	return GatherResults;
 }
 
 bool URiseResourceComponent::CanGatherFromNode_Implementation(AActor* Gatherer) const
@@ -89,4 +283,176 @@ bool URiseResourceComponent::CanGatherFromNode_Implementation(AActor* Gatherer)
 	// In child classes, we would want to check certain traits of the gatherer.
 	// For example, low strength races may not be able to mine stone.
 	return true;
-}
\ No newline at end of file
+}
+
+void URiseResourceComponent::SetRegrowthEnabled(bool bEnabled)
+{
+	if (bRegrowthEnabled == bEnabled)
+	{
+		return;
+	}
+
+	bRegrowthEnabled = bEnabled;
+
+	if (bRegrowthEnabled)
+	{
+		ScheduleRegrowth();
+	}
+	else
+	{
+		// Remember how far along the regrowth was, so enabling it again resumes rather than restarts it.
+		URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+		if (SchedulerSubsystem && SchedulerSubsystem->IsEventScheduled(RegrowthHandle))
+		{
+			RegrowthTimeRemaining = SchedulerSubsystem->GetTimeRemaining(RegrowthHandle);
+		}
+
+		CancelRegrowth();
+	}
+}
+
+FRiseResourceAmount URiseResourceComponent::Withdraw(FRiseResourceAmount DesiredAmount)
+{
+	FRiseResourceAmount ModifiedDesiredAmount = FRiseResourceMath::Multiply(FMath::Max(DesiredAmount, 0), FixedResourceMultiplier);
+	ModifiedDesiredAmount = FMath::Min(ModifiedDesiredAmount, CurrentResourceAmount);
+
+	CurrentResourceAmount -= ModifiedDesiredAmount;
+
+	return ModifiedDesiredAmount;
+}
+
+FRiseResourceAmount URiseResourceComponent::UnitsToWithdraw(int32 DesiredUnits)
+{
+	return FRiseResourceMath::FromUnits(FMath::Clamp(DesiredUnits, 0, MAX_int32 / RISE_RESOURCE_AMOUNT_ONE));
+}
+
+void URiseResourceComponent::NotifyDepleted()
+{
+	AActor* Owner = GetOwner();
+
+	UE_LOG(LogRise, Log, TEXT("%s resource node has been depleted."), *Owner->GetName());
+
+	// Take the node out of the index first so gatherers looking for a new node do not find it again.
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->UnregisterResourceNode(this);
+	}
+
+	OnResourceDepleted.Broadcast(Owner, this);
+
+	// Nodes that grow back stay in place, hidden, until they do. Nodes promoted from a resource
+	// field are handed back to the field instead.
+	if (RegrowthDelay > 0.f && !ResourceField.IsValid())
+	{
+		Owner->SetActorHiddenInGame(true);
+		Owner->SetActorEnableCollision(false);
+		Owner->FlushNetDormancy();
+
+		bAwaitingRegrowth = true;
+		ScheduleRegrowth();
+		return;
+	}
+
+	// Depleted nodes are recycled if their class is pooled, and destroyed otherwise.
+	URiseActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<URiseActorPoolSubsystem>(GetWorld());
+	if (PoolSubsystem)
+	{
+		PoolSubsystem->ReleaseActor(Owner);
+	}
+	else
+	{
+		Owner->Destroy();
+	}
+}
+
+void URiseResourceComponent::UpdateReplicatedAmount()
+{
+	// Round up so clients only see an empty node once it really is empty.
+	int32 Units = FRiseResourceMath::ToUnits(CurrentResourceAmount + RISE_RESOURCE_AMOUNT_ONE - 1);
+	uint16 NewReplicatedResourceUnits = static_cast<uint16>(FMath::Clamp(Units, 0, static_cast<int32>(MAX_uint16)));
+
+	if (NewReplicatedResourceUnits == ReplicatedResourceUnits)
+	{
+		return;
+	}
+
+	ReplicatedResourceUnits = NewReplicatedResourceUnits;
+
+	AActor* Owner = GetOwner();
+	if (Owner->GetIsReplicated())
+	{
+		Owner->FlushNetDormancy();
+
+		URiseEconomySubsystem* EconomySubsystem = UWorld::GetSubsystem<URiseEconomySubsystem>(GetWorld());
+		if (EconomySubsystem)
+		{
+			EconomySubsystem->RecordResourceReplication(EstimatedAmountUpdateBytes);
+		}
+	}
+}
+
+void URiseResourceComponent::ReturnToResourceField()
+{
+	ARiseResourceField* Field = ResourceField.Get();
+	if (Field)
+	{
+		Field->ReturnInstance(ResourceFieldInstance, CurrentResourceAmount);
+	}
+
+	ResourceField.Reset();
+	ResourceFieldInstance = INDEX_NONE;
+}
+
+void URiseResourceComponent::ScheduleRegrowth()
+{
+	if (!bAwaitingRegrowth || !bRegrowthEnabled)
+	{
+		return;
+	}
+
+	URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+	if (SchedulerSubsystem && !SchedulerSubsystem->IsEventScheduled(RegrowthHandle))
+	{
+		float Delay = RegrowthTimeRemaining > 0.f ? RegrowthTimeRemaining : RegrowthDelay;
+		RegrowthTimeRemaining = 0.f;
+
+		RegrowthHandle = SchedulerSubsystem->ScheduleEvent(Delay, FSimpleDelegate::CreateUObject(this, &URiseResourceComponent::Regrow));
+	}
+}
+
+void URiseResourceComponent::CancelRegrowth()
+{
+	URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+	if (SchedulerSubsystem)
+	{
+		SchedulerSubsystem->CancelEvent(RegrowthHandle);
+	}
+
+	RegrowthHandle.Invalidate();
+}
+
+void URiseResourceComponent::Regrow()
+{
+	RegrowthHandle.Invalidate();
+	bAwaitingRegrowth = false;
+	RegrowthTimeRemaining = 0.f;
+
+	AActor* Owner = GetOwner();
+	Owner->SetActorHiddenInGame(false);
+	Owner->SetActorEnableCollision(true);
+
+	CurrentResourceAmount = FRiseResourceMath::FromUnits(MaxResourceAmount);
+	UpdateReplicatedAmount();
+	Owner->FlushNetDormancy();
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->RegisterResourceNode(this);
+	}
+
+	UE_LOG(LogRise, Log, TEXT("%s resource node has grown back."), *Owner->GetName());
+
+	OnResourceRegrown.Broadcast(Owner, this);
+}
@@ -0,0 +1,126 @@
+#include "Data/RiseClassManifest.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#include "RiseLog.h"
+
+const uint32 FRiseClassManifest::MagicNumber = 0x52434D46; // RCMF
+const uint32 FRiseClassManifest::Version = 1;
+
+FString FRiseClassManifest::GetDefaultFilename()
+{
+	return FPaths::ProjectContentDir() / TEXT("Data/Manifest/RiseClassManifest.bin");
+}
+
+bool FRiseClassManifest::LoadFromFile(const FString& Filename)
+{
+	ClassesByBaseClass.Empty();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Reader << *this;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogRise, Warning, TEXT("Class manifest %s is invalid or out of date."), *Filename);
+		ClassesByBaseClass.Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FRiseClassManifest::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Writer << const_cast<FRiseClassManifest&>(*this);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+bool FRiseClassManifest::ContainsBaseClass(const UClass* BaseClass) const
+{
+	return BaseClass && ClassesByBaseClass.Contains(*BaseClass->GetPathName());
+}
+
+const TArray<FRiseClassManifestEntry>* FRiseClassManifest::FindClasses(const UClass* BaseClass) const
+{
+	return BaseClass ? ClassesByBaseClass.Find(*BaseClass->GetPathName()) : nullptr;
+}
+
+FArchive& operator<<(FArchive& Ar, FRiseClassManifest& Manifest)
+{
+	uint32 MagicNumber = FRiseClassManifest::MagicNumber;
+	uint32 Version = FRiseClassManifest::Version;
+	Ar << MagicNumber;
+	Ar << Version;
+
+	if (Ar.IsLoading() && (MagicNumber != FRiseClassManifest::MagicNumber || Version != FRiseClassManifest::Version))
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	int32 NumBaseClasses = Manifest.ClassesByBaseClass.Num();
+	Ar << NumBaseClasses;
+
+	if (Ar.IsLoading())
+	{
+		Manifest.ClassesByBaseClass.Empty(NumBaseClasses);
+
+		for (int32 BaseClassIndex = 0; BaseClassIndex < NumBaseClasses && !Ar.IsError(); ++BaseClassIndex)
+		{
+			FString BaseClassPath;
+			int32 NumEntries = 0;
+			Ar << BaseClassPath;
+			Ar << NumEntries;
+
+			if (NumEntries < 0)
+			{
+				Ar.SetError();
+				break;
+			}
+
+			TArray<FRiseClassManifestEntry>& Entries = Manifest.ClassesByBaseClass.Add(*BaseClassPath);
+			Entries.Reserve(NumEntries);
+
+			for (int32 EntryIndex = 0; EntryIndex < NumEntries && !Ar.IsError(); ++EntryIndex)
+			{
+				FString ClassPath;
+				FRiseClassManifestEntry& Entry = Entries.AddDefaulted_GetRef();
+				Ar << ClassPath;
+				Ar << Entry.NameHint;
+
+				Entry.ClassPath = FSoftObjectPath(ClassPath);
+			}
+		}
+	}
+	else
+	{
+		for (TPair<FName, TArray<FRiseClassManifestEntry>>& BaseClass : Manifest.ClassesByBaseClass)
+		{
+			FString BaseClassPath = BaseClass.Key.ToString();
+			int32 NumEntries = BaseClass.Value.Num();
+			Ar << BaseClassPath;
+			Ar << NumEntries;
+
+			for (FRiseClassManifestEntry& Entry : BaseClass.Value)
+			{
+				FString ClassPath = Entry.ClassPath.ToString();
+				Ar << ClassPath;
+				Ar << Entry.NameHint;
+			}
+		}
+	}
+
+	return Ar;
+}
@@ -0,0 +1,182 @@
+#include "Data/RiseRecipeGraph.h"
+
+#include "Engine/DataTable.h"
+
+#include "RiseLog.h"
+#include "Data/RiseRecipeData.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+bool FRiseRecipeGraph::Compile(const UDataTable* DataTable, const URiseResourceRegistrySubsystem* ResourceRegistry, float EconomyTickInterval)
+{
+	Recipes.Reset();
+	RecipeIndices.Reset();
+	ProducingRecipes.Reset();
+
+	if (!DataTable || !ResourceRegistry)
+	{
+		return false;
+	}
+
+	if (!DataTable->GetRowStruct() || !DataTable->GetRowStruct()->IsChildOf(FRiseRecipeData::StaticStruct()))
+	{
+		UE_LOG(LogRise, Error, TEXT("%s does not contain recipe data."), *DataTable->GetName());
+		return false;
+	}
+
+	ProducingRecipes.SetNum(ResourceRegistry->GetNumResourceTypes());
+
+	// Resolve the rows in name order so the recipe order is stable for the same table contents.
+	TArray<FName> RowNames;
+	DataTable->GetRowMap().GenerateKeyArray(RowNames);
+	RowNames.Sort(FNameLexicalLess());
+
+	auto ResolveIngredients = [ResourceRegistry](const TArray<FRiseRecipeIngredient>& Ingredients, TArray<FRiseRecipeAmount, TInlineAllocator<2>>& OutAmounts)
+	{
+		for (const FRiseRecipeIngredient& Ingredient : Ingredients)
+		{
+			FRiseResourceId ResourceId = ResourceRegistry->GetResourceId(Ingredient.ResourceType);
+			if (ResourceId == RISE_RESOURCE_ID_NONE || Ingredient.Units <= 0)
+			{
+				return false;
+			}
+
+			// Merge repeated ingredients so each resource is checked and spent once per cycle.
+			FRiseRecipeAmount* Amount = OutAmounts.FindByPredicate([ResourceId](const FRiseRecipeAmount& Other) { return Other.ResourceId == ResourceId; });
+			if (Amount)
+			{
+				Amount->Amount += FRiseResourceMath::FromUnits(Ingredient.Units);
+			}
+			else
+			{
+				OutAmounts.Add({ ResourceId, FRiseResourceMath::FromUnits(Ingredient.Units) });
+			}
+		}
+
+		return true;
+	};
+
+	TArray<FRiseCompiledRecipe> UnorderedRecipes;
+	for (FName RowName : RowNames)
+	{
+		const FRiseRecipeData* Row = reinterpret_cast<const FRiseRecipeData*>(DataTable->GetRowMap().FindChecked(RowName));
+
+		FRiseCompiledRecipe Recipe;
+		Recipe.Name = RowName;
+
+		if (!ResolveIngredients(Row->Inputs, Recipe.Inputs) || !ResolveIngredients(Row->Outputs, Recipe.Outputs))
+		{
+			UE_LOG(LogRise, Warning, TEXT("Skipping recipe %s with an unknown resource or invalid quantity."), *RowName.ToString());
+			continue;
+		}
+
+		if (Recipe.Outputs.IsEmpty())
+		{
+			UE_LOG(LogRise, Warning, TEXT("Skipping recipe %s without outputs."), *RowName.ToString());
+			continue;
+		}
+
+		if (EconomyTickInterval > 0.f)
+		{
+			Recipe.CycleTicks = FMath::Max(1, FMath::RoundToInt(Row->CycleTime / EconomyTickInterval));
+		}
+
+		UnorderedRecipes.Add(MoveTemp(Recipe));
+	}
+
+	// Link each recipe to the recipes consuming its outputs.
+	TArray<TArray<int32>> UnorderedProducingRecipes;
+	UnorderedProducingRecipes.SetNum(ProducingRecipes.Num());
+
+	for (int32 RecipeIndex = 0; RecipeIndex < UnorderedRecipes.Num(); ++RecipeIndex)
+	{
+		for (const FRiseRecipeAmount& Output : UnorderedRecipes[RecipeIndex].Outputs)
+		{
+			UnorderedProducingRecipes[Output.ResourceId].AddUnique(RecipeIndex);
+		}
+	}
+
+	TArray<TArray<int32>> Dependents;
+	Dependents.SetNum(UnorderedRecipes.Num());
+
+	TArray<int32> NumDependencies;
+	NumDependencies.SetNumZeroed(UnorderedRecipes.Num());
+
+	for (int32 RecipeIndex = 0; RecipeIndex < UnorderedRecipes.Num(); ++RecipeIndex)
+	{
+		for (const FRiseRecipeAmount& Input : UnorderedRecipes[RecipeIndex].Inputs)
+		{
+			for (int32 ProducingIndex : UnorderedProducingRecipes[Input.ResourceId])
+			{
+				Dependents[ProducingIndex].Add(RecipeIndex);
+				++NumDependencies[RecipeIndex];
+			}
+		}
+	}
+
+	// Order the recipes so each one comes after everything producing its inputs (Kahn's algorithm).
+	TArray<int32> Order;
+	Order.Reserve(UnorderedRecipes.Num());
+
+	for (int32 RecipeIndex = 0; RecipeIndex < UnorderedRecipes.Num(); ++RecipeIndex)
+	{
+		if (NumDependencies[RecipeIndex] == 0)
+		{
+			Order.Add(RecipeIndex);
+		}
+	}
+
+	for (int32 OrderIndex = 0; OrderIndex < Order.Num(); ++OrderIndex)
+	{
+		for (int32 DependentIndex : Dependents[Order[OrderIndex]])
+		{
+			if (--NumDependencies[DependentIndex] == 0)
+			{
+				Order.Add(DependentIndex);
+			}
+		}
+	}
+
+	// Anything left over depends on itself through a cycle. Keep it, but it cannot be fed within a single tick.
+	for (int32 RecipeIndex = 0; RecipeIndex < UnorderedRecipes.Num(); ++RecipeIndex)
+	{
+		if (NumDependencies[RecipeIndex] > 0)
+		{
+			UE_LOG(LogRise, Warning, TEXT("Recipe %s is part of a production cycle and will use the outputs of the previous economy tick."), *UnorderedRecipes[RecipeIndex].Name.ToString());
+			Order.Add(RecipeIndex);
+		}
+	}
+
+	Recipes.Reserve(Order.Num());
+	for (int32 UnorderedIndex : Order)
+	{
+		FRiseCompiledRecipe& Recipe = UnorderedRecipes[UnorderedIndex];
+
+		RecipeIndices.Add(Recipe.Name, Recipes.Num());
+		for (const FRiseRecipeAmount& Output : Recipe.Outputs)
+		{
+			ProducingRecipes[Output.ResourceId].AddUnique(Recipes.Num());
+		}
+
+		Recipes.Add(MoveTemp(Recipe));
+	}
+
+	UE_LOG(LogRise, Log, TEXT("Compiled %i recipes from %s."), Recipes.Num(), *DataTable->GetName());
+
+	return true;
+}
+
+int32 FRiseRecipeGraph::FindRecipeIndex(FName RecipeName) const
+{
+	const int32* RecipeIndex = RecipeIndices.Find(RecipeName);
+	return RecipeIndex ? *RecipeIndex : INDEX_NONE;
+}
+
+TArrayView<const int32> FRiseRecipeGraph::GetProducingRecipes(FRiseResourceId ResourceId) const
+{
+	if (!ProducingRecipes.IsValidIndex(ResourceId))
+	{
+		return TArrayView<const int32>();
+	}
+
+	return ProducingRecipes[ResourceId];
+}
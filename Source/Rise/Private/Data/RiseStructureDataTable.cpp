@@ -0,0 +1,172 @@
+#include "Data/RiseStructureDataTable.h"
+
+#include "Engine/DataTable.h"
+
+#include "RiseLog.h"
+
+bool FRiseStructureDataTable::Compile(const UDataTable* DataTable)
+{
+	Rows.Reset();
+	Types.Reset();
+	TypeIndices.Reset();
+	RowIds.Reset();
+
+	if (!DataTable)
+	{
+		return false;
+	}
+
+	if (!DataTable->GetRowStruct() || !DataTable->GetRowStruct()->IsChildOf(FRiseStructureData::StaticStruct()))
+	{
+		UE_LOG(LogRise, Error, TEXT("%s does not contain structure data."), *DataTable->GetName());
+		return false;
+	}
+
+	// Group the rows by type and level before laying them out.
+	TMap<FName, TMap<int32, TPair<FName, const FRiseStructureData*>>> RowsByType;
+	for (const TPair<FName, uint8*>& Row : DataTable->GetRowMap())
+	{
+		FName TypeName;
+		int32 Level;
+		ParseRowName(Row.Key, TypeName, Level);
+
+		if (Level < 1 || Level > MAX_uint8)
+		{
+			UE_LOG(LogRise, Warning, TEXT("Skipping structure data row %s with invalid level %i."), *Row.Key.ToString(), Level);
+			continue;
+		}
+
+		RowsByType.FindOrAdd(TypeName).Add(Level, TPair<FName, const FRiseStructureData*>(Row.Key, reinterpret_cast<const FRiseStructureData*>(Row.Value)));
+	}
+
+	// Sort the types so ids are stable for the same table contents.
+	RowsByType.KeySort(FNameLexicalLess());
+
+	for (const TPair<FName, TMap<int32, TPair<FName, const FRiseStructureData*>>>& Type : RowsByType)
+	{
+		int32 NumLevels = 0;
+		for (const TPair<int32, TPair<FName, const FRiseStructureData*>>& LevelRow : Type.Value)
+		{
+			NumLevels = FMath::Max(NumLevels, LevelRow.Key);
+		}
+
+		if (Rows.Num() + NumLevels >= MAX_uint16)
+		{
+			UE_LOG(LogRise, Error, TEXT("%s contains too many structure rows."), *DataTable->GetName());
+			break;
+		}
+
+		FRiseStructureTypeLevels& TypeLevels = Types.AddDefaulted_GetRef();
+		TypeLevels.TypeName = Type.Key;
+		TypeLevels.FirstRow = Rows.Num();
+		TypeLevels.NumLevels = NumLevels;
+
+		TypeIndices.Add(Type.Key, Types.Num() - 1);
+
+		for (int32 Level = 1; Level <= NumLevels; ++Level)
+		{
+			const TPair<FName, const FRiseStructureData*>* LevelRow = Type.Value.Find(Level);
+			if (!LevelRow)
+			{
+				// Keep the levels contiguous so they can be addressed by offset.
+				UE_LOG(LogRise, Warning, TEXT("Structure %s is missing level %i. Default stats will be used."), *Type.Key.ToString(), Level);
+				Rows.AddDefaulted();
+				continue;
+			}
+
+			FRiseStructureDataId Id;
+			Id.Index = Rows.Add(*LevelRow->Value);
+
+			RowIds.Add(LevelRow->Key, Id);
+		}
+	}
+
+	UE_LOG(LogRise, Log, TEXT("Compiled %i structure types (%i rows) from %s."), Types.Num(), Rows.Num(), *DataTable->GetName());
+
+	return true;
+}
+
+bool FRiseStructureDataTable::ApplyRows(const FRiseStructureDataTable& NewTable, TArray<FRiseStructureDataId>& OutChangedIds)
+{
+	if (Rows.Num() != NewTable.Rows.Num() || Types.Num() != NewTable.Types.Num())
+	{
+		return false;
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < Types.Num(); ++TypeIndex)
+	{
+		if (Types[TypeIndex].TypeName != NewTable.Types[TypeIndex].TypeName || Types[TypeIndex].NumLevels != NewTable.Types[TypeIndex].NumLevels)
+		{
+			return false;
+		}
+	}
+
+	const UScriptStruct* RowStruct = FRiseStructureData::StaticStruct();
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		if (RowStruct->CompareScriptStruct(&Rows[RowIndex], &NewTable.Rows[RowIndex], PPF_None))
+		{
+			continue;
+		}
+
+		Rows[RowIndex] = NewTable.Rows[RowIndex];
+
+		FRiseStructureDataId Id;
+		Id.Index = RowIndex;
+		OutChangedIds.Add(Id);
+	}
+
+	return true;
+}
+
+FRiseStructureDataId FRiseStructureDataTable::FindId(FName TypeName, int32 Level) const
+{
+	const int32* TypeIndex = TypeIndices.Find(TypeName);
+	if (!TypeIndex)
+	{
+		return FRiseStructureDataId();
+	}
+
+	const FRiseStructureTypeLevels& TypeLevels = Types[*TypeIndex];
+	if (Level < 1 || Level > TypeLevels.NumLevels)
+	{
+		return FRiseStructureDataId();
+	}
+
+	FRiseStructureDataId Id;
+	Id.Index = TypeLevels.FirstRow + Level - 1;
+	return Id;
+}
+
+FRiseStructureDataId FRiseStructureDataTable::FindIdByRowName(FName RowName) const
+{
+	const FRiseStructureDataId* Id = RowIds.Find(RowName);
+	return Id ? *Id : FRiseStructureDataId();
+}
+
+int32 FRiseStructureDataTable::GetNumLevels(FName TypeName) const
+{
+	const int32* TypeIndex = TypeIndices.Find(TypeName);
+	return TypeIndex ? Types[*TypeIndex].NumLevels : 0;
+}
+
+void FRiseStructureDataTable::ParseRowName(FName RowName, FName& OutTypeName, int32& OutLevel)
+{
+	FString Name = RowName.ToString();
+
+	int32 LevelStart = Name.Len();
+	while (LevelStart > 0 && FChar::IsDigit(Name[LevelStart - 1]))
+	{
+		--LevelStart;
+	}
+
+	if (LevelStart == Name.Len() || LevelStart == 0)
+	{
+		OutTypeName = RowName;
+		OutLevel = 1;
+		return;
+	}
+
+	OutTypeName = *Name.Left(LevelStart);
+	OutLevel = FCString::Atoi(*Name.Mid(LevelStart));
+}
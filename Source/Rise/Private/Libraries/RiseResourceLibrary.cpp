@@ -0,0 +1,18 @@
+#include "Libraries/RiseResourceLibrary.h"
+
+#include "RiseResourceTypes.h"
+
+int32 URiseResourceLibrary::ResourceAmountToUnits(int32 Amount)
+{
+	return FRiseResourceMath::ToUnits(Amount);
+}
+
+float URiseResourceLibrary::ResourceAmountToFloat(int32 Amount)
+{
+	return FRiseResourceMath::ToFloat(Amount);
+}
+
+int32 URiseResourceLibrary::UnitsToResourceAmount(int32 Units)
+{
+	return FRiseResourceMath::FromUnits(Units);
+}
@@ -2,19 +2,37 @@
 
 #include "AIController.h"
 #include "EngineUtils.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/GameStateBase.h"
 #include "Kismet/GameplayStatics.h"
 
 #include "RiseFeatureFlags.h"
 #include "RiseLog.h"
 #include "RiseMacros.h"
 #include "RisePlayerStart.h"
+#include "RiseStats.h"
 #include "RiseTeamInfo.h"
+#include "Components/RiseOwnableComponent.h"
+#include "Subsystems/RiseActorPoolSubsystem.h"
+#include "Subsystems/RiseEconomySubsystem.h"
+#include "Subsystems/RiseOwnershipSubsystem.h"
+#include "Subsystems/RiseProductionSubsystem.h"
 
 ARiseGameMode::ARiseGameMode()
 {
 	TeamClass = ARiseTeamInfo::StaticClass();
 	// In the primary game mode the player is playing against themselves.
 	NumTeams = 1;
+
+	// The game mode only ticks to drain the spawn queue and to evaluate match conditions
+	// at the end of a frame in which match events were raised.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+	SpawnFrameBudgetMs = 2.f;
+	bSpawnClassesLoaded = false;
 }
 
 void ARiseGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
@@ -35,6 +53,68 @@ void ARiseGameMode::InitGame(const FString& MapName, const FString& Options, FSt
 
 		UE_LOG(LogRise, Log, TEXT("Team[%i] %s created."), TeamIndex, *Team->GetName());
 	}
+
+	// Build the PlayerStart table once so PlayerStart lookups never iterate the world.
+	for (TActorIterator<ARisePlayerStart> It(GetWorld()); It; ++It)
+	{
+		ARisePlayerStart* PlayerStart = *It;
+		PlayerStarts.Add(PlayerStart);
+
+		if (PlayerStart->GetPlayer())
+		{
+			PlayerStartsByPlayer.Add(PlayerStart->GetPlayer(), PlayerStart);
+		}
+	}
+
+	for (int32 PlayerStartIndex = PlayerStarts.Num() - 1; PlayerStartIndex >= 0; --PlayerStartIndex)
+	{
+		if (!PlayerStarts[PlayerStartIndex]->GetPlayer())
+		{
+			FreePlayerStarts.Add(PlayerStarts[PlayerStartIndex]);
+		}
+	}
+
+	PendingMatchEvents.Init(ERiseMatchEvent::None, ARisePlayerState::PLAYER_INDEX_NONE);
+	PendingSpawnCounts.Init(0, ARisePlayerState::PLAYER_INDEX_NONE);
+	DecidedPlayers.Init(false, ARisePlayerState::PLAYER_INDEX_NONE);
+	DueTimerConditions.Init(false, MatchConditions.Num());
+	MatchConditionTimerHandles.SetNum(MatchConditions.Num());
+
+	for (int32 ConditionIndex = 0; ConditionIndex < MatchConditions.Num(); ++ConditionIndex)
+	{
+		URiseMatchCondition* MatchCondition = MatchConditions[ConditionIndex];
+		if (!MatchCondition)
+		{
+			continue;
+		}
+
+		MatchCondition->InitializeCondition(this);
+
+		float EvaluationInterval = MatchCondition->GetEvaluationInterval();
+		if (EnumHasAnyFlags(MatchCondition->GetDependentEvents(), ERiseMatchEvent::Timer) && EvaluationInterval > 0.f)
+		{
+			FTimerDelegate TimerDelegate = FTimerDelegate::CreateWeakLambda(this, [this, ConditionIndex]()
+			{
+				DueTimerConditions[ConditionIndex] = true;
+				NotifyMatchEventForAllPlayers(ERiseMatchEvent::Timer);
+			});
+
+			GetWorldTimerManager().SetTimer(MatchConditionTimerHandles[ConditionIndex], TimerDelegate, EvaluationInterval, true);
+		}
+	}
+
+	// Stream in the spawn classes while the map finishes loading, so the first spawn
+	// of each class does not stall the game thread with a synchronous load.
+	PreloadSpawnClasses();
+
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnedActorsChangedHandle = OwnershipSubsystem->OnOwnedActorsChanged.AddWeakLambda(this, [this](uint8 PlayerIndex)
+		{
+			NotifyMatchEvent(PlayerIndex, ERiseMatchEvent::OwnershipChanged);
+		});
+	}
 }
 
 void ARiseGameMode::BeginPlay()
@@ -62,6 +142,68 @@ void ARiseGameMode::BeginPlay()
 #endif RISE_AIPLAYERS_ENABLED
 }
 
+void ARiseGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->OnOwnedActorsChanged.Remove(OwnedActorsChangedHandle);
+	}
+
+	for (FTimerHandle& TimerHandle : MatchConditionTimerHandles)
+	{
+		GetWorldTimerManager().ClearTimer(TimerHandle);
+	}
+
+	if (SpawnClassesHandle.IsValid())
+	{
+		SpawnClassesHandle->CancelHandle();
+		SpawnClassesHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARiseGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Disable ticking before evaluating so that events raised during evaluation
+	// (for example units being removed from a defeated player) schedule another pass.
+	SetActorTickEnabled(false);
+
+	ProcessSpawnQueue();
+	EvaluateMatchConditions();
+
+	if (HasPendingSpawns() && bSpawnClassesLoaded)
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void ARiseGameMode::Logout(AController* Exiting)
+{
+	ARisePlayerState* PlayerState = Exiting ? Cast<ARisePlayerState>(Exiting->PlayerState) : nullptr;
+	if (IsValid(PlayerState))
+	{
+		ARiseTeamInfo* Team = PlayerState->GetTeam();
+		if (Team)
+		{
+			Team->RemoveFromTeam(Exiting);
+		}
+
+		ReleasePlayerIndex(PlayerState);
+	}
+
+	ARisePlayerStart* PlayerStart = GetRisePlayerStartForPlayer(Exiting);
+	if (PlayerStart)
+	{
+		SetPlayerStartPlayer(PlayerStart, nullptr);
+	}
+
+	Super::Logout(Exiting);
+}
+
 void ARiseGameMode::RestartPlayer(AController* NewPlayer)
 {
 	if (!NewPlayer || NewPlayer->IsPendingKillPending())
@@ -86,7 +228,7 @@ void ARiseGameMode::RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* S
 		PlayerStart = GetUnassignedPlayerStart();
 		if (PlayerStart)
 		{
-			PlayerStart->SetPlayer(NewPlayer);
+			SetPlayerStartPlayer(PlayerStart, NewPlayer);
 			UE_LOG(LogRise, Log, TEXT("Start spot %s is now occupied by player %s."), *PlayerStart->GetName(), *NewPlayer->GetName());
 		}
 		else
@@ -100,8 +242,18 @@ void ARiseGameMode::RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* S
 	ARisePlayerState* PlayerState = Cast<ARisePlayerState>(NewPlayer->PlayerState);
 	if (IsValid(PlayerState))
 	{
-		uint8 PlayerIndex = GetAvailablePlayerIndex();
-		PlayerState->SetPlayerIndex(PlayerIndex);
+		// A restarting player keeps the slot they were already assigned.
+		uint8 PlayerIndex = PlayerState->GetPlayerIndex();
+		if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+		{
+			PlayerIndex = AllocatePlayerIndex();
+			PlayerState->SetPlayerIndex(PlayerIndex);
+
+			if (DecidedPlayers.IsValidIndex(PlayerIndex))
+			{
+				DecidedPlayers[PlayerIndex] = false;
+			}
+		}
 
 		ARiseTeamInfo* Team = PlayerState->GetTeam();
 		if (!Team)
@@ -113,146 +265,221 @@ void ARiseGameMode::RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* S
 		}
 		Teams[Team->GetTeamIndex()]->AddToTeam(NewPlayer);
 
-		for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+		URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+		if (OwnershipSubsystem)
 		{
-			AActor* Actor = *It;
+			TArrayView<URiseOwnableComponent* const> InitialOwnables = OwnershipSubsystem->GetInitiallyOwnedComponents(PlayerIndex);
 
-			URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
-			if (IsValid(OwnableComponent) && OwnableComponent->GetInitialOwnerPlayerIndex() == PlayerIndex)
+			TArray<AActor*> InitialActors;
+			InitialActors.Reserve(InitialOwnables.Num());
+			for (URiseOwnableComponent* OwnableComponent : InitialOwnables)
 			{
-				TransferActorOwnership(Actor, NewPlayer);
+				if (IsValid(OwnableComponent))
+				{
+					InitialActors.Add(OwnableComponent->GetOwner());
+				}
 			}
+
+			TransferActorsOwnership(InitialActors, NewPlayer);
 		}
 	}
 
-	if (!PlayerSpawnParameters.IsEmpty())
+	AActor* SpawnOrigin = PlayerStart ? PlayerStart : StartSpot;
+	if (!PlayerSpawnParameters.IsEmpty() && SpawnOrigin)
 	{
 		//TODO: We probably don't want to use the PlayerStart's rotation to do this.
 		//		We probably need to reach out to the grid manager and detect the
 		//		"town center's" rotation on the grid.
 		FRotator ActorSpawnRotation(ForceInit);
-		ActorSpawnRotation.Yaw = StartSpot->GetActorRotation().Yaw;
+		ActorSpawnRotation.Yaw = SpawnOrigin->GetActorRotation().Yaw;
+
+		FVector SpawnLocation = SpawnOrigin->GetActorLocation();
 
-		FVector SpawnLocation = StartSpot->GetActorLocation();
+		TArray<FRiseSpawnRequest> SpawnRequests;
+		SpawnRequests.Reserve(PlayerSpawnParameters.Num());
 
 		for (int32 SpawnParamIndex = 0; SpawnParamIndex < PlayerSpawnParameters.Num(); ++SpawnParamIndex)
 		{
 			const FRisePlayerUnitSpawnParameters& SpawnParameters = PlayerSpawnParameters[SpawnParamIndex];
 
-			FVector ActorSpawnLocation = SpawnLocation + SpawnParameters.UnitLocation;
-			FTransform ActorSpawnTransform = FTransform(ActorSpawnRotation, ActorSpawnLocation);
-
-			bool bAssignedOwnership;
-			AActor* SpawnedActor = SpawnActorForPlayer(SpawnParameters.Unit, NewPlayer, ActorSpawnTransform, bAssignedOwnership);
-			if (!bAssignedOwnership)
-			{
-				UE_LOG(LogRise, Log, TEXT("Unable to assign starting actor %s to player."), *SpawnedActor->GetName());
-			}
-
-			//TODO: Depending on how we decide to create buildings, the actor that is spawned may
-			//		not be in a usable state. In that case we need to complete construction of
-			//      that building. We can do that here.
+			FRiseSpawnRequest& SpawnRequest = SpawnRequests.AddDefaulted_GetRef();
+			SpawnRequest.ActorClass = SpawnParameters.Unit;
+			SpawnRequest.ActorOwner = NewPlayer;
+			SpawnRequest.SpawnTransform = FTransform(ActorSpawnRotation, SpawnLocation + SpawnParameters.UnitLocation);
 		}
+
+		//TODO: Depending on how we decide to create buildings, the actors that are spawned may
+		//		not be in a usable state. In that case we need to complete construction of
+		//      those buildings in the completion callback.
+		EnqueueSpawnRequests(MoveTemp(SpawnRequests));
 	}
 }
 
 ARisePlayerStart* ARiseGameMode::GetRisePlayerStartForPlayer(AController* Player) const
 {
-	for (TActorIterator<ARisePlayerStart> It(GetWorld()); It; ++It)
-	{
-		ARisePlayerStart* PlayerStart = *It;
-		if (PlayerStart->GetPlayer() == Player)
-		{
-			return PlayerStart;
-		}
-	}
-
-	return nullptr;
+	ARisePlayerStart* const* PlayerStart = PlayerStartsByPlayer.Find(Player);
+	return PlayerStart ? *PlayerStart : nullptr;
 }
 
 ARisePlayerStart* ARiseGameMode::GetOrAssignPlayerStartForPlayer(AController* Player)
 {
-	ARisePlayerStart* FirstEmptySpot = nullptr;
-
-	for (TActorIterator<ARisePlayerStart> It(GetWorld()); It; ++It)
+	ARisePlayerStart* PlayerStart = GetRisePlayerStartForPlayer(Player);
+	if (PlayerStart)
 	{
-		ARisePlayerStart* PlayerStart = *It;
-		if (PlayerStart->GetPlayer() == Player)
-		{
-			return PlayerStart;
-		}
-		else if (PlayerStart->GetPlayer() == nullptr)
-		{
-			FirstEmptySpot = PlayerStart;
-		}
+		return PlayerStart;
 	}
 
-	if (FirstEmptySpot)
+	PlayerStart = GetUnassignedPlayerStart();
+	if (PlayerStart)
 	{
-		FirstEmptySpot->SetPlayer(Player);
+		SetPlayerStartPlayer(PlayerStart, Player);
 	}
 
-	return FirstEmptySpot;
+	return PlayerStart;
 }
 
 ARisePlayerStart* ARiseGameMode::GetUnassignedPlayerStart() const
 {
-	for (TActorIterator<ARisePlayerStart> It(GetWorld()); It; ++It)
+	for (int32 FreeIndex = FreePlayerStarts.Num() - 1; FreeIndex >= 0; --FreeIndex)
 	{
-		ARisePlayerStart* PlayerStart = *It;
-		if (PlayerStart->GetPlayer() == nullptr)
+		if (IsValid(FreePlayerStarts[FreeIndex]))
 		{
-			return PlayerStart;
+			return FreePlayerStarts[FreeIndex];
 		}
 	}
 
 	return nullptr;
 }
 
+void ARiseGameMode::SetPlayerStartPlayer(ARisePlayerStart* PlayerStart, AController* Player)
+{
+	if (!PlayerStart)
+	{
+		return;
+	}
+
+	AController* OldPlayer = PlayerStart->GetPlayer();
+	if (OldPlayer == Player)
+	{
+		return;
+	}
+
+	// A player can only occupy one PlayerStart at a time.
+	ARisePlayerStart* PreviousPlayerStart = GetRisePlayerStartForPlayer(Player);
+	if (PreviousPlayerStart)
+	{
+		SetPlayerStartPlayer(PreviousPlayerStart, nullptr);
+	}
+
+	PlayerStart->SetPlayer(Player);
+
+	if (OldPlayer)
+	{
+		PlayerStartsByPlayer.Remove(OldPlayer);
+	}
+	else if (FreePlayerStarts.Num() > 0 && FreePlayerStarts.Last() == PlayerStart)
+	{
+		// The common case: the start was just handed out by GetUnassignedPlayerStart().
+		FreePlayerStarts.Pop(false);
+	}
+	else
+	{
+		FreePlayerStarts.RemoveSingle(PlayerStart);
+	}
+
+	if (Player)
+	{
+		PlayerStartsByPlayer.Add(Player, PlayerStart);
+	}
+	else
+	{
+		FreePlayerStarts.Add(PlayerStart);
+	}
+}
+
 TArray<ARiseTeamInfo*> ARiseGameMode::GetTeams() const
+{
+	RISE_COUNT_ARRAY_COPY(Teams);
+
+	return Teams;
+}
+
+const TArray<ARiseTeamInfo*>& ARiseGameMode::GetTeamsView() const
 {
 	return Teams;
 }
 
-uint8 ARiseGameMode::GetAvailablePlayerIndex()
+uint8 ARiseGameMode::AllocatePlayerIndex()
 {
-	UWorld* World = GetWorld();
-	if (!IsValid(World))
+	int32 PlayerIndex = AllocatedPlayerIndices.FindFirstFree(ARisePlayerState::PLAYER_INDEX_NONE);
+	if (PlayerIndex == INDEX_NONE)
 	{
+		// We have no room for them.
 		return ARisePlayerState::PLAYER_INDEX_NONE;
 	}
 
-	// TODO: There's gotta be a better way to do this.
-	TArray<const ARisePlayerState*> PlayerStates;
-	for (TActorIterator<ARisePlayerState> It(World); It; ++It)
+	AllocatedPlayerIndices.Add(PlayerIndex);
+
+	return PlayerIndex;
+}
+
+void ARiseGameMode::FreePlayerIndex(uint8 PlayerIndex)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
 	{
-		PlayerStates.Add(*It);
+		return;
 	}
 
-	Algo::SortBy(PlayerStates, &ARisePlayerState::GetPlayerIndex);
+	AllocatedPlayerIndices.Remove(PlayerIndex);
+}
+
+void ARiseGameMode::ReleasePlayerIndex(ARisePlayerState* PlayerState)
+{
+	uint8 PlayerIndex = PlayerState->GetPlayerIndex();
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return;
+	}
 
-	for (int32 PlayerIndex = 0; PlayerIndex < ARisePlayerState::PLAYER_INDEX_NONE; ++PlayerIndex)
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
 	{
-		// If we have exceeded the length of our array the condition
-		// below *must* have failed in every indice, meaning there are
-		// no discrepencies between the player's index and their index
-		// in the state array. In that case go ahead and add them to the end.
-		if (!PlayerStates.IsValidIndex(PlayerIndex))
-		{
-			return PlayerIndex;
-		}
+		OwnershipSubsystem->ReleasePlayerIndex(PlayerIndex);
+	}
+
+	URiseEconomySubsystem* EconomySubsystem = UWorld::GetSubsystem<URiseEconomySubsystem>(GetWorld());
+	if (EconomySubsystem)
+	{
+		EconomySubsystem->ReleasePlayerIndex(PlayerIndex);
+	}
+
+	URiseProductionSubsystem* ProductionSubsystem = UWorld::GetSubsystem<URiseProductionSubsystem>(GetWorld());
+	if (ProductionSubsystem)
+	{
+		ProductionSubsystem->ReleasePlayerIndex(PlayerIndex);
+	}
 
-		// If the player's index does not match their index in the player
-		// state array, that player state array index is free to use as
-		// a player state index.
-		if (PlayerStates[PlayerIndex]->GetPlayerIndex() != PlayerIndex)
+	// Drop the player's queued spawns. They are skipped when their turn comes and no longer count towards the index.
+	for (FRiseSpawnBatch& Batch : SpawnQueue)
+	{
+		for (int32 RequestIndex = Batch.NextRequestIndex; RequestIndex < Batch.Requests.Num(); ++RequestIndex)
 		{
-			return PlayerIndex;
+			FRiseSpawnRequest& Request = Batch.Requests[RequestIndex];
+			if (Request.PlayerIndex == PlayerIndex)
+			{
+				Request.ActorClass.Reset();
+				Request.ActorOwner = nullptr;
+				Request.PlayerIndex = ARisePlayerState::PLAYER_INDEX_NONE;
+			}
 		}
 	}
 
-	// We have no room for them.
-	return ARisePlayerState::PLAYER_INDEX_NONE;
+	PendingSpawnCounts[PlayerIndex] = 0;
+	PendingMatchEvents[PlayerIndex] = ERiseMatchEvent::None;
+	DecidedPlayers[PlayerIndex] = false;
+
+	PlayerState->SetPlayerIndex(ARisePlayerState::PLAYER_INDEX_NONE);
+	FreePlayerIndex(PlayerIndex);
 }
 
 AAIController* ARiseGameMode::SpawnAIPlayer()
@@ -289,52 +516,315 @@ AActor* ARiseGameMode::SpawnActorForPlayer(TSubclassOf<AActor> ActorClass, ACont
 {
 	bOutActorAssignedOwnership = false;
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	// Reuse a pooled actor if one is available.
+	URiseActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<URiseActorPoolSubsystem>(GetWorld());
+	AActor* SpawnedActor = PoolSubsystem ? PoolSubsystem->AcquireActor(ActorClass, SpawnTransform) : nullptr;
+
+	if (SpawnedActor)
+	{
+		SpawnedActor->SetOwner(ActorOwner);
 
-	AActor* SpawnedActor = GetWorld()->SpawnActor<AActor>(ActorClass->GetDefaultObject()->GetClass(), SpawnTransform, SpawnParams);
-	if (SpawnedActor && ActorOwner)
+		if (ActorOwner)
+		{
+			bOutActorAssignedOwnership = TransferActorOwnership(SpawnedActor, ActorOwner);
+		}
+	}
+	else
 	{
-		UE_LOG(LogRise, Log, TEXT("Player %s spawned unit %s at location %s"), *SpawnedActor->GetName(), *ActorOwner->GetName(), *SpawnTransform.GetLocation().ToString());
+		// Defer construction so the owning player is assigned before the construction script and BeginPlay run.
+		SpawnedActor = GetWorld()->SpawnActorDeferred<AActor>(ActorClass, SpawnTransform, ActorOwner, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!SpawnedActor)
+		{
+			return nullptr;
+		}
+
+		if (ActorOwner)
+		{
+			bOutActorAssignedOwnership = TransferActorOwnership(SpawnedActor, ActorOwner);
+		}
+
+		SpawnedActor->FinishSpawning(SpawnTransform);
+
+		// Ownable components added in the Blueprint only exist once construction has finished.
+		if (ActorOwner && !bOutActorAssignedOwnership)
+		{
+			bOutActorAssignedOwnership = TransferActorOwnership(SpawnedActor, ActorOwner);
+		}
+	}
 
-		bOutActorAssignedOwnership = TransferActorOwnership(SpawnedActor, ActorOwner);
+	if (ActorOwner)
+	{
+		UE_LOG(LogRise, Log, TEXT("Player %s spawned unit %s at location %s"), *ActorOwner->GetName(), *SpawnedActor->GetName(), *SpawnTransform.GetLocation().ToString());
 	}
 
 	return SpawnedActor;
 }
 
-bool ARiseGameMode::TransferActorOwnership(AActor* Actor, AController* NewOwner)
+void ARiseGameMode::EnqueueSpawnRequests(TArray<FRiseSpawnRequest> Requests, FRiseSpawnBatchCompleteDelegate OnComplete)
 {
-	if (!Actor)
+	if (Requests.IsEmpty())
 	{
-		return false;
+		OnComplete.ExecuteIfBound(TArray<AActor*>());
+		return;
 	}
 
-	URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
+	for (FRiseSpawnRequest& Request : Requests)
+	{
+		ARisePlayerState* PlayerState = Request.ActorOwner ? Cast<ARisePlayerState>(Request.ActorOwner->PlayerState) : nullptr;
+		Request.PlayerIndex = PlayerState ? PlayerState->GetPlayerIndex() : ARisePlayerState::PLAYER_INDEX_NONE;
+
+		if (PendingSpawnCounts.IsValidIndex(Request.PlayerIndex))
+		{
+			++PendingSpawnCounts[Request.PlayerIndex];
+		}
+	}
+
+	FRiseSpawnBatch& Batch = SpawnQueue.AddDefaulted_GetRef();
+	Batch.SpawnedActors.Reserve(Requests.Num());
+	Batch.Requests = MoveTemp(Requests);
+	Batch.OnComplete = MoveTemp(OnComplete);
+
+	if (bSpawnClassesLoaded)
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+bool ARiseGameMode::HasPendingSpawns() const
+{
+	return !SpawnQueue.IsEmpty();
+}
+
+bool ARiseGameMode::AreSpawnClassesLoaded() const
+{
+	return bSpawnClassesLoaded;
+}
+
+void ARiseGameMode::PreloadSpawnClasses()
+{
+	TArray<FSoftObjectPath> ClassPaths;
+
+	for (const FRisePlayerUnitSpawnParameters& SpawnParameters : PlayerSpawnParameters)
+	{
+		if (!SpawnParameters.Unit.IsNull())
+		{
+			ClassPaths.AddUnique(SpawnParameters.Unit.ToSoftObjectPath());
+		}
+	}
+
+	for (const URiseMatchCondition* MatchCondition : MatchConditions)
+	{
+		if (MatchCondition)
+		{
+			MatchCondition->GetPreloadClasses(ClassPaths);
+		}
+	}
+
+	for (const TSoftClassPtr<AActor>& PreloadClass : PreloadClasses)
+	{
+		if (!PreloadClass.IsNull())
+		{
+			ClassPaths.AddUnique(PreloadClass.ToSoftObjectPath());
+		}
+	}
+
+	if (ClassPaths.IsEmpty())
+	{
+		OnSpawnClassesLoaded();
+		return;
+	}
+
+	UE_LOG(LogRise, Log, TEXT("Preloading %i spawn classes."), ClassPaths.Num());
+
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+	SpawnClassesHandle = StreamableManager.RequestAsyncLoad(MoveTemp(ClassPaths), FStreamableDelegate::CreateUObject(this, &ARiseGameMode::OnSpawnClassesLoaded), FStreamableManager::AsyncLoadHighPriority);
+
+	// Everything may already have been in memory.
+	if (!SpawnClassesHandle.IsValid() || SpawnClassesHandle->HasLoadCompleted())
+	{
+		OnSpawnClassesLoaded();
+	}
+}
+
+void ARiseGameMode::OnSpawnClassesLoaded()
+{
+	if (bSpawnClassesLoaded)
+	{
+		return;
+	}
+
+	bSpawnClassesLoaded = true;
+
+	UE_LOG(LogRise, Log, TEXT("Spawn classes loaded."));
+
+	if (HasPendingSpawns())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void ARiseGameMode::ProcessSpawnQueue()
+{
+	// Hold queued spawns until their classes are in memory.
+	if (!bSpawnClassesLoaded)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = SpawnFrameBudgetMs / 1000.0;
+
+	bool bSpawnedAny = false;
+
+	while (!SpawnQueue.IsEmpty())
+	{
+		// Spawned actors may queue more spawns from BeginPlay, so the queue is re-read
+		// after every spawn rather than holding references into it.
+		while (SpawnQueue[0].Requests.IsValidIndex(SpawnQueue[0].NextRequestIndex))
+		{
+			// Always make some progress, even with a zero budget.
+			if (bSpawnedAny && FPlatformTime::Seconds() - StartTime >= Budget)
+			{
+				return;
+			}
+
+			const FRiseSpawnRequest Request = SpawnQueue[0].Requests[SpawnQueue[0].NextRequestIndex++];
+			bSpawnedAny = true;
+
+			// Always count down the index the request was queued under, even if the owner has since left.
+			if (PendingSpawnCounts.IsValidIndex(Request.PlayerIndex))
+			{
+				--PendingSpawnCounts[Request.PlayerIndex];
+
+				// Conditions skipped while the player's units were queued get another look.
+				NotifyMatchEvent(Request.PlayerIndex, ERiseMatchEvent::OwnershipChanged);
+			}
+
+			UClass* ActorClass = Request.ActorClass.Get();
+			if (!ActorClass && !Request.ActorClass.IsNull())
+			{
+				UE_LOG(LogRise, Warning, TEXT("Spawn class %s was not preloaded and is being loaded synchronously."), *Request.ActorClass.ToString());
+				ActorClass = Request.ActorClass.LoadSynchronous();
+			}
+
+			bool bAssignedOwnership;
+			AActor* SpawnedActor = SpawnActorForPlayer(ActorClass, Request.ActorOwner, Request.SpawnTransform, bAssignedOwnership);
+			if (!SpawnedActor)
+			{
+				continue;
+			}
+
+			if (Request.ActorOwner && !bAssignedOwnership)
+			{
+				UE_LOG(LogRise, Log, TEXT("Unable to assign spawned actor %s to player."), *SpawnedActor->GetName());
+			}
+
+			SpawnQueue[0].SpawnedActors.Add(SpawnedActor);
+		}
+
+		// Remove the batch before calling back so the callback can queue more spawns.
+		FRiseSpawnBatch CompletedBatch = MoveTemp(SpawnQueue[0]);
+		SpawnQueue.RemoveAt(0);
+
+		CompletedBatch.OnComplete.ExecuteIfBound(CompletedBatch.SpawnedActors);
+	}
+}
+
+bool ARiseGameMode::TransferActorOwnership(AActor* Actor, AController* NewOwner)
+{
 	ARisePlayerState* OldOwnerState = nullptr;
+	return TransferActorOwnership(Actor, NewOwner, false, OldOwnerState);
+}
+
+int32 ARiseGameMode::TransferActorsOwnership(const TArray<AActor*>& Actors, AController* NewOwner)
+{
 	ARisePlayerState* NewOwnerState = NewOwner ? Cast<ARisePlayerState>(NewOwner->PlayerState) : nullptr;
 
-	if (OwnableComponent)
+	TArray<AActor*> GainedActors;
+	TMap<ARisePlayerState*, TArray<AActor*>> LostActorsByPlayer;
+
+	for (AActor* Actor : Actors)
+	{
+		ARisePlayerState* OldOwnerState = nullptr;
+		if (!TransferActorOwnership(Actor, NewOwner, true, OldOwnerState))
+		{
+			continue;
+		}
+
+		GainedActors.Add(Actor);
+
+		if (IsValid(OldOwnerState))
+		{
+			LostActorsByPlayer.FindOrAdd(OldOwnerState).Add(Actor);
+		}
+	}
+
+	if (GainedActors.IsEmpty())
 	{
-		OldOwnerState = OwnableComponent->GetPlayerOwner();
+		return 0;
 	}
 
-	if (OldOwnerState == NewOwnerState)
+	UE_LOG(LogRise, Log, TEXT("Transferred ownership of %i actors to %s."), GainedActors.Num(), NewOwner ? *NewOwner->GetName() : TEXT("nobody"));
+
+	// Send one notification per affected player instead of one per actor.
+	const TArray<AActor*> NoActors;
+	for (const TPair<ARisePlayerState*, TArray<AActor*>>& LostActors : LostActorsByPlayer)
+	{
+		LostActors.Key->NotifyActorsOwnershipChanged(NoActors, LostActors.Value);
+	}
+
+	if (IsValid(NewOwnerState))
+	{
+		NewOwnerState->NotifyActorsOwnershipChanged(GainedActors, NoActors);
+	}
+
+	return GainedActors.Num();
+}
+
+bool ARiseGameMode::TransferActorOwnership(AActor* Actor, AController* NewOwner, bool bSuppressNotification, ARisePlayerState*& OutOldOwner)
+{
+	OutOldOwner = nullptr;
+
+	if (!Actor)
 	{
 		return false;
 	}
 
-	if (!IsValid(OldOwnerState))
+	URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
+	if (!OwnableComponent)
 	{
-		UE_LOG(LogRise, Log, TEXT("Transferred ownership of %s to %s."), *Actor->GetName(), *NewOwner->GetName());
+		return false;
 	}
-	else
+
+	ARisePlayerState* OldOwnerState = OwnableComponent->GetPlayerOwner();
+	ARisePlayerState* NewOwnerState = NewOwner ? Cast<ARisePlayerState>(NewOwner->PlayerState) : nullptr;
+
+	if (OldOwnerState == NewOwnerState)
+	{
+		return false;
+	}
+
+	if (!bSuppressNotification)
 	{
-		UE_LOG(LogRise, Log, TEXT("Transferred ownership of %s from %s to %s."), *Actor->GetName(), *OldOwnerState->GetName(), *NewOwner->GetName());
+		if (!IsValid(OldOwnerState))
+		{
+			UE_LOG(LogRise, Log, TEXT("Transferred ownership of %s to %s."), *Actor->GetName(), NewOwner ? *NewOwner->GetName() : TEXT("nobody"));
+		}
+		else
+		{
+			UE_LOG(LogRise, Log, TEXT("Transferred ownership of %s from %s to %s."), *Actor->GetName(), *OldOwnerState->GetName(), NewOwner ? *NewOwner->GetName() : TEXT("nobody"));
+		}
 	}
 
+	OutOldOwner = OldOwnerState;
+
 	Actor->SetOwner(NewOwner);
-	OwnableComponent->SetPlayerOwnerByController(NewOwner);
+	OwnableComponent->SetPlayerOwnerByPlayerState(NewOwnerState, bSuppressNotification);
 
 	//TODO: If the player has GodMode enabled, set it here.
 	//APawn* Pawn = Cast<APawn>(Actor);
@@ -348,9 +838,23 @@ bool ARiseGameMode::TransferActorOwnership(AActor* Actor, AController* NewOwner)
 
 void ARiseGameMode::NotifyActorKilled(AActor* Actor, AController* ActorOwner)
 {
+	URiseOwnableComponent* OwnableComponent = Actor ? Actor->FindComponentByClass<URiseOwnableComponent>() : nullptr;
+
+	// Let conditions depending on structure loss know the owner of a killed structure lost it.
+	if (IsValid(OwnableComponent) && OwnableComponent->IsStructure() && OwnableComponent->GetPlayerOwner())
+	{
+		NotifyMatchEvent(OwnableComponent->GetPlayerOwner()->GetPlayerIndex(), ERiseMatchEvent::StructureLost);
+	}
+
+	// A killed actor no longer counts towards its owner, even if it has not been destroyed yet.
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem && IsValid(OwnableComponent))
+	{
+		OwnershipSubsystem->UnregisterOwnable(OwnableComponent);
+	}
+
 	if (ActorOwner)
 	{
-		URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
 		if (IsValid(OwnableComponent))
 		{
 			ARisePlayerState* PlayerState = OwnableComponent->GetPlayerOwner();
@@ -373,15 +877,121 @@ void ARiseGameMode::NotifyActorKilled(AActor* Actor, AController* ActorOwner)
 
 void ARiseGameMode::OnActorKilled_Implementation(AActor* Actor, AController* ActorOwner)
 {
-	for (FRiseDefeatConditionBase& DefeatCondition : DefeatConditions)
+	// Match conditions are re-evaluated through the ownership change raised when
+	// the killed actor was removed from its owner, and the structure loss raised
+	// when it was a structure.
+}
+
+void ARiseGameMode::NotifyMatchEvent(uint8 PlayerIndex, ERiseMatchEvent Event)
+{
+	if (!PendingMatchEvents.IsValidIndex(PlayerIndex))
+	{
+		return;
+	}
+
+	PendingMatchEvents[PlayerIndex] |= Event;
+
+	if (!IsActorTickEnabled())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void ARiseGameMode::NotifyMatchEventForAllPlayers(ERiseMatchEvent Event)
+{
+	for (ERiseMatchEvent& PlayerEvents : PendingMatchEvents)
+	{
+		PlayerEvents |= Event;
+	}
+
+	if (!IsActorTickEnabled())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void ARiseGameMode::EvaluateMatchConditions()
+{
+	if (!GameState)
+	{
+		return;
+	}
+
+	for (APlayerState* BasePlayerState : GameState->PlayerArray)
 	{
-		if (DefeatCondition.IsDefeated(Actor, ActorOwner))
+		ARisePlayerState* PlayerState = Cast<ARisePlayerState>(BasePlayerState);
+		if (!IsValid(PlayerState))
+		{
+			continue;
+		}
+
+		uint8 PlayerIndex = PlayerState->GetPlayerIndex();
+		if (!PendingMatchEvents.IsValidIndex(PlayerIndex))
 		{
-			UE_LOG(LogRise, Log, TEXT("Player %s was defeated - %s"), *ActorOwner->GetName(), *DefeatCondition.GetDefeatReason());
-			NotifyPlayerDefeated(ActorOwner);
+			continue;
+		}
+
+		// Leave the events pending until the player's queued actors have spawned, otherwise
+		// a partially spawned starting army could count as a defeat.
+		if (PendingSpawnCounts[PlayerIndex] > 0)
+		{
+			continue;
+		}
+
+		ERiseMatchEvent PlayerEvents = PendingMatchEvents[PlayerIndex];
+		PendingMatchEvents[PlayerIndex] = ERiseMatchEvent::None;
+
+		if (PlayerEvents == ERiseMatchEvent::None || DecidedPlayers[PlayerIndex])
+		{
+			continue;
+		}
+
+		for (int32 ConditionIndex = 0; ConditionIndex < MatchConditions.Num(); ++ConditionIndex)
+		{
+			URiseMatchCondition* MatchCondition = MatchConditions[ConditionIndex];
+			if (!MatchCondition)
+			{
+				continue;
+			}
+
+			// Only conditions whose inputs have changed need to be evaluated. Timer events
+			// only apply to the conditions whose own interval has elapsed.
+			ERiseMatchEvent RelevantEvents = PlayerEvents & MatchCondition->GetDependentEvents();
+			if (!DueTimerConditions[ConditionIndex])
+			{
+				RelevantEvents &= ~ERiseMatchEvent::Timer;
+			}
+
+			if (RelevantEvents == ERiseMatchEvent::None)
+			{
+				continue;
+			}
+
+			ERiseMatchConditionResult Result = MatchCondition->Evaluate(PlayerState);
+			if (Result == ERiseMatchConditionResult::None)
+			{
+				continue;
+			}
+
+			DecidedPlayers[PlayerIndex] = true;
+
+			AController* Player = Cast<AController>(PlayerState->GetOwner());
+			if (Result == ERiseMatchConditionResult::Defeated)
+			{
+				UE_LOG(LogRise, Log, TEXT("Player %s was defeated - %s"), *PlayerState->GetPlayerName(), *MatchCondition->GetResultReason());
+				NotifyPlayerDefeated(Player);
+			}
+			else
+			{
+				UE_LOG(LogRise, Log, TEXT("Player %s was victorious - %s"), *PlayerState->GetPlayerName(), *MatchCondition->GetResultReason());
+				NotifyPlayerVictorious(Player);
+			}
+
 			break;
 		}
 	}
+
+	DueTimerConditions.SetRange(0, DueTimerConditions.Num(), false);
 }
 
 void ARiseGameMode::NotifyPlayerResigned(AController* Player)
@@ -402,4 +1012,14 @@ void ARiseGameMode::NotifyPlayerDefeated(AController* Player)
 void ARiseGameMode::OnPlayerDefeated_Implementation(AController* Player)
 {
 
+}
+
+void ARiseGameMode::NotifyPlayerVictorious(AController* Player)
+{
+	OnPlayerVictorious(Player);
+}
+
+void ARiseGameMode::OnPlayerVictorious_Implementation(AController* Player)
+{
+
 }
\ No newline at end of file
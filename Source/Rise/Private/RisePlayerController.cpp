@@ -13,6 +13,7 @@
 #include "RiseLog.h"
 #include "RisePlayer.h"
 #include "RisePlayerState.h"
+#include "RiseStats.h"
 #include "Components/RiseSelectableComponent.h"
 #include "Libraries/RiseActorLibrary.h"
 #include "Volumes/RiseCameraBoundsVolume.h"
@@ -339,38 +340,6 @@ void ARisePlayerController::ClientGameHasEnded_Implementation(bool bIsWinner)
 	NotifyGameHasEnded(bIsWinner);
 }
 
-void ARisePlayerController::OnPlayerStateAvailable(ARisePlayerState* NewPlayerState)
-{
-	if (IsValid(NewPlayerState))
-	{
-		NewPlayerState->DiscoverOwnedActors();
-	}
-}
-
-void ARisePlayerController::InitPlayerState()
-{
-	Super::InitPlayerState();
-
-	if (!IsValid(PlayerState))
-	{
-		return;
-	}
-
-	OnPlayerStateAvailable(GetPlayerState());
-}
-
-void ARisePlayerController::OnRep_PlayerState()
-{
-	Super::OnRep_PlayerState();
-
-	if (!IsValid(PlayerState))
-	{
-		return;
-	}
-
-	OnPlayerStateAvailable(GetPlayerState());
-}
-
 ARisePlayer* const ARisePlayerController::GetRisePlayer() const
 {
 	return Cast<ARisePlayer>(GetPawn());
@@ -411,6 +380,13 @@ ARisePlayerState* ARisePlayerController::GetPlayerState() const
 }
 
 TArray<AActor*> ARisePlayerController::GetSelectedActors() const
+{
+	RISE_COUNT_ARRAY_COPY(SelectedActors);
+
+	return SelectedActors;
+}
+
+const TArray<AActor*>& ARisePlayerController::GetSelectedActorsView() const
 {
 	return SelectedActors;
 }
@@ -662,6 +638,11 @@ void ARisePlayerController::NotifyActorOwnerChanged(AActor* Actor)
 	OnActorOwnerChanged(Actor);
 }
 
+void ARisePlayerController::NotifyActorsOwnerChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors)
+{
+	OnActorsOwnerChanged(GainedActors, LostActors);
+}
+
 void ARisePlayerController::NotifyHoveredActorChanged(AActor* Actor)
 {
 	OnHoveredActorChanged(Actor);
@@ -7,13 +7,17 @@
 #include "RisePlayerController.h"
 #include "RiseTeamInfo.h"
 #include "RiseLog.h"
-#include "Components/RiseOwnableComponent.h"
+#include "RiseStats.h"
+#include "Subsystems/RiseOwnershipSubsystem.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
 
 const uint8 ARisePlayerState::PLAYER_INDEX_NONE = 255;
 
 ARisePlayerState::ARisePlayerState()
 {
 	PlayerIndex = PLAYER_INDEX_NONE;
+	ResourceTypesChecksum = 0;
+	bResourceTypesMismatch = false;
 }
 
 void ARisePlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -22,6 +26,22 @@ void ARisePlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 
 	DOREPLIFETIME(ARisePlayerState, PlayerIndex);
 	DOREPLIFETIME(ARisePlayerState, Team);
+	DOREPLIFETIME_CONDITION(ARisePlayerState, ResourceStockpile, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ARisePlayerState, ResourceTypesChecksum, COND_InitialOnly);
+}
+
+void ARisePlayerState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (HasAuthority())
+	{
+		URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+		if (ResourceRegistry)
+		{
+			ResourceTypesChecksum = ResourceRegistry->GetChecksum();
+		}
+	}
 }
 
 uint8 ARisePlayerState::GetPlayerIndex() const
@@ -31,7 +51,28 @@ uint8 ARisePlayerState::GetPlayerIndex() const
 
 void ARisePlayerState::SetPlayerIndex(uint8 NewPlayerIndex)
 {
+	uint8 OldPlayerIndex = PlayerIndex;
 	PlayerIndex = NewPlayerIndex;
+
+	if (OldPlayerIndex != NewPlayerIndex)
+	{
+		OnPlayerIndexChangedCallback(OldPlayerIndex);
+	}
+}
+
+void ARisePlayerState::OnPlayerIndexChangedCallback(uint8 OldPlayerIndex)
+{
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (OwnershipSubsystem)
+	{
+		OwnershipSubsystem->NotifyPlayerIndexChanged(this, OldPlayerIndex);
+	}
+
+	// Keep the team's mask in sync, as the player may have joined it before they were assigned an index.
+	if (Team)
+	{
+		Team->NotifyPlayerIndexChanged(OldPlayerIndex, PlayerIndex);
+	}
 }
 
 ARiseTeamInfo* ARisePlayerState::GetTeam() const
@@ -51,8 +92,6 @@ bool ARisePlayerState::IsSameTeamAs(const ARisePlayerState* Other) const
 		return false;
 	}
 
-	ARiseTeamInfo* OtherTeam = Other->Team;
-
 	// If two players are not on a team, they are not considered to be on the
 	// same team.
 	if (!Team || !Other->Team)
@@ -60,33 +99,32 @@ bool ARisePlayerState::IsSameTeamAs(const ARisePlayerState* Other) const
 		return false;
 	}
 
-	return Team->GetTeamIndex() == OtherTeam->GetTeamIndex();
+	// Players are normally assigned an index before joining a team.
+	if (Other->PlayerIndex == PLAYER_INDEX_NONE)
+	{
+		return Team == Other->Team;
+	}
+
+	return Team->IsPlayerIndexOnTeam(Other->PlayerIndex);
 }
 
 TArray<AActor*> ARisePlayerState::GetOwnedActors() const
 {
-	return OwnedActors;
+	TArrayView<AActor* const> OwnedActors = GetOwnedActorsView();
+	RISE_COUNT_ARRAY_COPY(OwnedActors);
+
+	return TArray<AActor*>(OwnedActors);
 }
 
-void ARisePlayerState::DiscoverOwnedActors()
+TArrayView<AActor* const> ARisePlayerState::GetOwnedActorsView() const
 {
-	OwnedActors.Empty();
-
-	for (TActorIterator<AActor> ActorIt(GetWorld()); ActorIt; ++ActorIt)
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GetWorld());
+	if (!OwnershipSubsystem)
 	{
-		AActor* Actor = *ActorIt;
-
-		if (!IsValid(Actor))
-		{
-			continue;
-		}
-
-		URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
-		if (IsValid(OwnableComponent) && OwnableComponent->GetOwner() == this)
-		{
-			OwnedActors.AddUnique(Actor);
-		}
+		return TArrayView<AActor* const>();
 	}
+
+	return OwnershipSubsystem->GetOwnedActors(PlayerIndex);
 }
 
 void ARisePlayerState::NotifyTeamChanged(ARiseTeamInfo* NewTeam)
@@ -122,21 +160,108 @@ void ARisePlayerState::NotifyActorOwnershipChanged(AActor* AffectedActor, ARiseP
 		return;
 	}
 
-	if (NewOwner == this)
+	//TODO: Do we need AI controllers to be aware of this?
+	ARisePlayerController* PlayerController = Cast<ARisePlayerController>(GetOwner());
+	if (PlayerController)
 	{
-		OwnedActors.AddUnique(AffectedActor);
+		PlayerController->NotifyActorOwnerChanged(AffectedActor);
 	}
-	else
+
+	OnActorOwnershipChanged(AffectedActor, OldOwner, NewOwner);
+}
+
+void ARisePlayerState::NotifyActorsOwnershipChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors)
+{
+	if (GainedActors.IsEmpty() && LostActors.IsEmpty())
 	{
-		OwnedActors.Remove(AffectedActor);
+		return;
 	}
 
 	//TODO: Do we need AI controllers to be aware of this?
 	ARisePlayerController* PlayerController = Cast<ARisePlayerController>(GetOwner());
 	if (PlayerController)
 	{
-		PlayerController->NotifyActorOwnerChanged(AffectedActor);
+		PlayerController->NotifyActorsOwnerChanged(GainedActors, LostActors);
 	}
 
-	OnActorOwnershipChanged(AffectedActor, OldOwner, NewOwner);
-}
\ No newline at end of file
+	OnActorsOwnershipChanged(GainedActors, LostActors);
+}
+
+float ARisePlayerState::GetResourceAmount(TSubclassOf<URiseResource> ResourceType) const
+{
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+	if (!ResourceRegistry || bResourceTypesMismatch)
+	{
+		return 0.f;
+	}
+
+	FRiseResourceId ResourceId = ResourceRegistry->GetResourceId(ResourceType);
+	return ResourceStockpile.IsValidIndex(ResourceId) ? FRiseResourceMath::ToFloat(ResourceStockpile[ResourceId]) : 0.f;
+}
+
+const TArray<FRiseResourceAmount>& ARisePlayerState::GetResourceStockpile() const
+{
+	return ResourceStockpile;
+}
+
+void ARisePlayerState::SetResourceStockpile(TArrayView<const FRiseResourceAmount> NewStockpile, const TArray<FRiseResourceDelta>& Deltas)
+{
+	ResourceStockpile = TArray<FRiseResourceAmount>(NewStockpile);
+
+	NotifyResourceStockpileChanged(Deltas);
+}
+
+void ARisePlayerState::NotifyResourceStockpileChanged(const TArray<FRiseResourceDelta>& Deltas)
+{
+	OnResourceStockpileChanged(Deltas);
+}
+
+void ARisePlayerState::OnResourceStockpileChangedCallback(const TArray<int32>& OldResourceStockpile)
+{
+	// The ids would be misread, so do not report changes to the wrong resources.
+	if (bResourceTypesMismatch)
+	{
+		return;
+	}
+
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+
+	// Several economy ticks may have been coalesced into this update, so diff against what we had.
+	TArray<FRiseResourceDelta> Deltas;
+	for (int32 ResourceId = 0; ResourceId < ResourceStockpile.Num(); ++ResourceId)
+	{
+		FRiseResourceAmount OldAmount = OldResourceStockpile.IsValidIndex(ResourceId) ? OldResourceStockpile[ResourceId] : 0;
+		if (ResourceStockpile[ResourceId] == OldAmount)
+		{
+			continue;
+		}
+
+		FRiseResourceDelta& Delta = Deltas.AddDefaulted_GetRef();
+		Delta.ResourceId = ResourceId;
+		Delta.ResourceType = ResourceRegistry ? ResourceRegistry->GetResourceType(ResourceId) : nullptr;
+		Delta.FixedDelta = ResourceStockpile[ResourceId] - OldAmount;
+		Delta.FixedNewAmount = ResourceStockpile[ResourceId];
+		Delta.Delta = FRiseResourceMath::ToFloat(Delta.FixedDelta);
+		Delta.NewAmount = FRiseResourceMath::ToFloat(Delta.FixedNewAmount);
+	}
+
+	if (!Deltas.IsEmpty())
+	{
+		NotifyResourceStockpileChanged(Deltas);
+	}
+}
+
+void ARisePlayerState::OnResourceTypesChecksumChangedCallback()
+{
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+	if (!ResourceRegistry)
+	{
+		return;
+	}
+
+	bResourceTypesMismatch = ResourceTypesChecksum != ResourceRegistry->GetChecksum();
+	if (bResourceTypesMismatch)
+	{
+		UE_LOG(LogRise, Error, TEXT("The server's resource types (checksum %08x) differ from ours (checksum %08x). Resource stockpiles cannot be read."), ResourceTypesChecksum, ResourceRegistry->GetChecksum());
+	}
+}
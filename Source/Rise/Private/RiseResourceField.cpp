@@ -0,0 +1,357 @@
+#include "RiseResourceField.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Net/UnrealNetwork.h"
+
+#include "RiseLog.h"
+#include "Components/RiseResourceComponent.h"
+#include "Subsystems/RiseActorPoolSubsystem.h"
+#include "Subsystems/RiseResourceNodeIndexSubsystem.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+ARiseResourceField::ARiseResourceField()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+
+	InstancesComponent = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("Instances"));
+	RootComponent = InstancesComponent;
+
+	InitialResourceAmount = 100;
+	ResourceId = RISE_RESOURCE_ID_NONE;
+	PromotedIdleTime = 30.f;
+}
+
+void ARiseResourceField::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ARiseResourceField, HiddenInstanceBits);
+}
+
+void ARiseResourceField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!NodeClass)
+	{
+		UE_LOG(LogRise, Error, TEXT("No node class assigned to resource field %s."), *GetName());
+	}
+
+	int32 NumInstances = InstancesComponent->GetInstanceCount();
+	if (HasAuthority())
+	{
+		InstanceAmounts.Init(FRiseResourceMath::FromUnits(InitialResourceAmount), NumInstances);
+		HiddenInstanceBits.SetNumZeroed(FMath::DivideAndRoundUp(NumInstances, 32));
+	}
+
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+	ResourceId = ResourceRegistry ? ResourceRegistry->GetResourceId(ResourceClass) : RISE_RESOURCE_ID_NONE;
+
+	// Clients may already have hidden some instances before play began.
+	InstanceNodeIndexCells.SetNumZeroed(NumInstances);
+	InstanceNodeIndexSlots.Init(INDEX_NONE, NumInstances);
+	AppliedHiddenInstanceBits.SetNumZeroed(FMath::DivideAndRoundUp(NumInstances, 32));
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; ++InstanceIndex)
+		{
+			if (AppliedHiddenInstanceBits[InstanceIndex >> 5] & (1u << (InstanceIndex & 31)))
+			{
+				continue;
+			}
+
+			FTransform InstanceTransform;
+			InstancesComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+			NodeIndexSubsystem->RegisterFieldInstance(this, InstanceIndex, ResourceId, InstanceTransform.GetLocation());
+		}
+	}
+}
+
+void ARiseResourceField::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		for (int32 InstanceIndex = 0; InstanceIndex < InstanceNodeIndexSlots.Num(); ++InstanceIndex)
+		{
+			NodeIndexSubsystem->UnregisterFieldInstance(this, InstanceIndex);
+		}
+	}
+
+	URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+	if (SchedulerSubsystem)
+	{
+		for (TPair<int32, FRisePromotedInstance>& PromotedInstance : PromotedInstances)
+		{
+			SchedulerSubsystem->CancelEvent(PromotedInstance.Value.IdleCheckHandle);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+URiseResourceComponent* ARiseResourceField::PromoteInstance(int32 InstanceIndex)
+{
+	if (!HasAuthority() || !NodeClass || !InstanceAmounts.IsValidIndex(InstanceIndex) || InstanceAmounts[InstanceIndex] == 0)
+	{
+		return nullptr;
+	}
+
+	if (FRisePromotedInstance* ExistingInstance = PromotedInstances.Find(InstanceIndex))
+	{
+		return ExistingInstance->Actor->FindComponentByClass<URiseResourceComponent>();
+	}
+
+	FTransform InstanceTransform;
+	InstancesComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+
+	// Reuse a pooled node actor if one is available.
+	URiseActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<URiseActorPoolSubsystem>(GetWorld());
+	AActor* NodeActor = PoolSubsystem ? PoolSubsystem->AcquireActor(NodeClass, InstanceTransform) : nullptr;
+
+	if (!NodeActor)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		NodeActor = GetWorld()->SpawnActor<AActor>(NodeClass, InstanceTransform, SpawnParameters);
+		if (!NodeActor)
+		{
+			UE_LOG(LogRise, Error, TEXT("Failed to promote instance %i of resource field %s."), InstanceIndex, *GetName());
+			return nullptr;
+		}
+	}
+
+	URiseResourceComponent* ResourceComponent = NodeActor->FindComponentByClass<URiseResourceComponent>();
+	if (!ResourceComponent)
+	{
+		UE_LOG(LogRise, Error, TEXT("Node class %s of resource field %s has no resource component."), *NodeClass->GetName(), *GetName());
+		NodeActor->Destroy();
+		return nullptr;
+	}
+
+	ResourceComponent->CurrentResourceAmount = InstanceAmounts[InstanceIndex];
+	ResourceComponent->UpdateReplicatedAmount();
+	ResourceComponent->ResourceField = this;
+	ResourceComponent->ResourceFieldInstance = InstanceIndex;
+
+	PromotedInstances.Add(InstanceIndex).Actor = NodeActor;
+	ScheduleIdleCheck(InstanceIndex);
+
+	SetInstanceHiddenBit(InstanceIndex, true);
+	SetInstanceHidden(InstanceIndex, true);
+	InstancesComponent->MarkRenderStateDirty();
+
+	return ResourceComponent;
+}
+
+void ARiseResourceField::DemoteInstance(int32 InstanceIndex)
+{
+	FRisePromotedInstance* PromotedInstance = PromotedInstances.Find(InstanceIndex);
+	if (!PromotedInstance || !PromotedInstance->Actor)
+	{
+		return;
+	}
+
+	AActor* NodeActor = PromotedInstance->Actor;
+
+	// Releasing or destroying the actor writes its remaining amount back through ReturnInstance().
+	URiseActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<URiseActorPoolSubsystem>(GetWorld());
+	if (PoolSubsystem)
+	{
+		PoolSubsystem->ReleaseActor(NodeActor);
+	}
+	else
+	{
+		NodeActor->Destroy();
+	}
+}
+
+FRiseResourceAmount ARiseResourceField::GetInstanceResourceAmount(int32 InstanceIndex) const
+{
+	if (const FRisePromotedInstance* PromotedInstance = PromotedInstances.Find(InstanceIndex))
+	{
+		const URiseResourceComponent* ResourceComponent = PromotedInstance->Actor->FindComponentByClass<URiseResourceComponent>();
+		return ResourceComponent ? ResourceComponent->GetFixedResourceAmount() : 0;
+	}
+
+	return InstanceAmounts.IsValidIndex(InstanceIndex) ? InstanceAmounts[InstanceIndex] : 0;
+}
+
+URiseResourceComponent* ARiseResourceField::GetResourceComponentFromHit(const FHitResult& Hit)
+{
+	AActor* HitActor = Hit.GetActor();
+	if (!HitActor)
+	{
+		return nullptr;
+	}
+
+	ARiseResourceField* ResourceField = Cast<ARiseResourceField>(HitActor);
+	if (ResourceField)
+	{
+		// Traces against instanced meshes report the instance index as the hit item.
+		if (Hit.GetComponent() != ResourceField->InstancesComponent || Hit.Item == INDEX_NONE)
+		{
+			return nullptr;
+		}
+
+		return ResourceField->PromoteInstance(Hit.Item);
+	}
+
+	return HitActor->FindComponentByClass<URiseResourceComponent>();
+}
+
+void ARiseResourceField::ReturnInstance(int32 InstanceIndex, FRiseResourceAmount ResourceAmount)
+{
+	if (!InstanceAmounts.IsValidIndex(InstanceIndex))
+	{
+		return;
+	}
+
+	InstanceAmounts[InstanceIndex] = FMath::Max(ResourceAmount, 0);
+
+	FRisePromotedInstance PromotedInstance;
+	if (PromotedInstances.RemoveAndCopyValue(InstanceIndex, PromotedInstance))
+	{
+		URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+		if (SchedulerSubsystem)
+		{
+			SchedulerSubsystem->CancelEvent(PromotedInstance.IdleCheckHandle);
+		}
+	}
+
+	// Depleted nodes stay hidden.
+	if (ResourceAmount > 0)
+	{
+		SetInstanceHiddenBit(InstanceIndex, false);
+		SetInstanceHidden(InstanceIndex, false);
+		InstancesComponent->MarkRenderStateDirty();
+	}
+}
+
+void ARiseResourceField::SetInstanceHiddenBit(int32 InstanceIndex, bool bHidden)
+{
+	uint32 Mask = 1u << (InstanceIndex & 31);
+	uint32& Word = HiddenInstanceBits[InstanceIndex >> 5];
+
+	Word = bHidden ? (Word | Mask) : (Word & ~Mask);
+}
+
+void ARiseResourceField::SetInstanceHidden(int32 InstanceIndex, bool bHidden)
+{
+	if (!AppliedHiddenInstanceBits.IsValidIndex(InstanceIndex >> 5))
+	{
+		return;
+	}
+
+	uint32 Mask = 1u << (InstanceIndex & 31);
+	uint32& Word = AppliedHiddenInstanceBits[InstanceIndex >> 5];
+	if (((Word & Mask) != 0) == bHidden)
+	{
+		return;
+	}
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+
+	if (bHidden)
+	{
+		FTransform InstanceTransform;
+		if (!InstancesComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+		{
+			return;
+		}
+
+		Word |= Mask;
+		HiddenInstanceTransforms.Add(InstanceIndex, InstanceTransform);
+
+		if (NodeIndexSubsystem)
+		{
+			NodeIndexSubsystem->UnregisterFieldInstance(this, InstanceIndex);
+		}
+
+		// Instances cannot be removed without shifting the indices of the others, so collapse it instead.
+		InstanceTransform.SetScale3D(FVector::ZeroVector);
+		InstancesComponent->UpdateInstanceTransform(InstanceIndex, InstanceTransform, true, false, true);
+	}
+	else
+	{
+		Word &= ~Mask;
+
+		FTransform InstanceTransform;
+		if (HiddenInstanceTransforms.RemoveAndCopyValue(InstanceIndex, InstanceTransform))
+		{
+			InstancesComponent->UpdateInstanceTransform(InstanceIndex, InstanceTransform, true, false, true);
+
+			if (NodeIndexSubsystem)
+			{
+				NodeIndexSubsystem->RegisterFieldInstance(this, InstanceIndex, ResourceId, InstanceTransform.GetLocation());
+			}
+		}
+	}
+}
+
+void ARiseResourceField::ScheduleIdleCheck(int32 InstanceIndex)
+{
+	FRisePromotedInstance* PromotedInstance = PromotedInstances.Find(InstanceIndex);
+	if (!PromotedInstance || PromotedIdleTime <= 0.f)
+	{
+		return;
+	}
+
+	URiseSchedulerSubsystem* SchedulerSubsystem = UWorld::GetSubsystem<URiseSchedulerSubsystem>(GetWorld());
+	if (!SchedulerSubsystem)
+	{
+		return;
+	}
+
+	// Nodes are checked rather than rescheduled on every gather, so busy nodes cost one event per idle period.
+	PromotedInstance->IdleCheckAmount = GetInstanceResourceAmount(InstanceIndex);
+	PromotedInstance->IdleCheckHandle = SchedulerSubsystem->ScheduleEvent(PromotedIdleTime, FSimpleDelegate::CreateUObject(this, &ARiseResourceField::OnPromotedInstanceIdle, InstanceIndex));
+}
+
+void ARiseResourceField::OnPromotedInstanceIdle(int32 InstanceIndex)
+{
+	FRisePromotedInstance* PromotedInstance = PromotedInstances.Find(InstanceIndex);
+	if (!PromotedInstance || !PromotedInstance->Actor)
+	{
+		return;
+	}
+
+	PromotedInstance->IdleCheckHandle.Invalidate();
+
+	URiseResourceComponent* ResourceComponent = PromotedInstance->Actor->FindComponentByClass<URiseResourceComponent>();
+	if (ResourceComponent && (ResourceComponent->GetFixedResourceAmount() != PromotedInstance->IdleCheckAmount || !ResourceComponent->PendingExtractions.IsEmpty()))
+	{
+		ScheduleIdleCheck(InstanceIndex);
+		return;
+	}
+
+	DemoteInstance(InstanceIndex);
+}
+
+void ARiseResourceField::OnHiddenInstancesCallback()
+{
+	if (AppliedHiddenInstanceBits.Num() < HiddenInstanceBits.Num())
+	{
+		AppliedHiddenInstanceBits.SetNumZeroed(HiddenInstanceBits.Num());
+	}
+
+	// Only the words that changed need to be walked.
+	for (int32 WordIndex = 0; WordIndex < HiddenInstanceBits.Num(); ++WordIndex)
+	{
+		uint32 ChangedBits = HiddenInstanceBits[WordIndex] ^ AppliedHiddenInstanceBits[WordIndex];
+		while (ChangedBits != 0)
+		{
+			int32 Bit = FMath::CountTrailingZeros(ChangedBits);
+			ChangedBits &= ChangedBits - 1;
+
+			int32 InstanceIndex = WordIndex * 32 + Bit;
+			SetInstanceHidden(InstanceIndex, (HiddenInstanceBits[WordIndex] & (1u << Bit)) != 0);
+		}
+	}
+
+	InstancesComponent->MarkRenderStateDirty();
+}
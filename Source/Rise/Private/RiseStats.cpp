@@ -0,0 +1,6 @@
+#include "RiseStats.h"
+
+DEFINE_STAT(STAT_RiseBlueprintArrayCopies);
+DEFINE_STAT(STAT_RiseBlueprintArrayElementsCopied);
+DEFINE_STAT(STAT_RiseResourceReplicationBytesPerSecond);
+DEFINE_STAT(STAT_RiseResourceReplicationUpdates);
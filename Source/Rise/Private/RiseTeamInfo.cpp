@@ -3,6 +3,7 @@
 #include "Net/UnrealNetwork.h"
 
 #include "RisePlayerState.h"
+#include "RiseStats.h"
 
 ARiseTeamInfo::ARiseTeamInfo()
 {
@@ -18,6 +19,7 @@ void ARiseTeamInfo::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME_CONDITION(ARiseTeamInfo, TeamIndex, COND_InitialOnly);
+	DOREPLIFETIME(ARiseTeamInfo, PlayerMask);
 }
 
 void ARiseTeamInfo::AddToTeam(AController* Player)
@@ -27,13 +29,20 @@ void ARiseTeamInfo::AddToTeam(AController* Player)
 		return;
 	}
 
-	// If the player is already on this team, return early.
+	ARisePlayerState* PlayerState = Cast<ARisePlayerState>(Player->PlayerState);
+
+	// If the player is already on this team, only make sure their index is in the mask, as they
+	// may have joined before they were assigned one.
 	if (TeamPlayers.Contains(Player))
 	{
+		if (PlayerState && PlayerState->GetPlayerIndex() != ARisePlayerState::PLAYER_INDEX_NONE)
+		{
+			PlayerMask.Add(PlayerState->GetPlayerIndex());
+		}
+
 		return;
 	}
 
-	ARisePlayerState* PlayerState = Cast<ARisePlayerState>(Player->PlayerState);
 	if (!PlayerState)
 	{
 		return;
@@ -50,6 +59,11 @@ void ARiseTeamInfo::AddToTeam(AController* Player)
 	PlayerState->SetTeam(this);
 	TeamPlayers.Add(Player);
 
+	if (PlayerState->GetPlayerIndex() != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		PlayerMask.Add(PlayerState->GetPlayerIndex());
+	}
+
 	// Send off notifications.
 	PlayerState->NotifyTeamChanged(this);
 }
@@ -76,6 +90,11 @@ void ARiseTeamInfo::RemoveFromTeam(AController* Player)
 		return;
 	}
 
+	if (PlayerState->GetPlayerIndex() != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		PlayerMask.Remove(PlayerState->GetPlayerIndex());
+	}
+
 	PlayerState->SetTeam(nullptr);
 	PlayerState->NotifyTeamChanged(nullptr);
 }
@@ -87,9 +106,48 @@ bool ARiseTeamInfo::IsOnTeam(AController* Player) const
 		return false;
 	}
 
+	ARisePlayerState* PlayerState = Cast<ARisePlayerState>(Player->PlayerState);
+	if (PlayerState && PlayerState->GetPlayerIndex() != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return PlayerMask.Contains(PlayerState->GetPlayerIndex());
+	}
+
 	return TeamPlayers.Contains(Player);
 }
 
+bool ARiseTeamInfo::IsPlayerIndexOnTeam(uint8 PlayerIndex) const
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return false;
+	}
+
+	return PlayerMask.Contains(PlayerIndex);
+}
+
+const FRisePlayerMask& ARiseTeamInfo::GetPlayerMask() const
+{
+	return PlayerMask;
+}
+
+void ARiseTeamInfo::NotifyPlayerIndexChanged(uint8 OldPlayerIndex, uint8 NewPlayerIndex)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (OldPlayerIndex != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		PlayerMask.Remove(OldPlayerIndex);
+	}
+
+	if (NewPlayerIndex != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		PlayerMask.Add(NewPlayerIndex);
+	}
+}
+
 uint8 ARiseTeamInfo::GetTeamIndex() const
 {
 	return TeamIndex;
@@ -101,6 +159,13 @@ void ARiseTeamInfo::SetTeamIndex(uint8 NewTeamIndex)
 }
 
 TArray<AController*> ARiseTeamInfo::GetTeamPlayers() const
+{
+	RISE_COUNT_ARRAY_COPY(TeamPlayers);
+
+	return TeamPlayers;
+}
+
+const TArray<AController*>& ARiseTeamInfo::GetTeamPlayersView() const
 {
 	return TeamPlayers;
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "Rules/RiseMatchCondition.h"
+
+#include "RiseGameMode.h"
+#include "RisePlayerState.h"
+
+void URiseMatchCondition::InitializeCondition(ARiseGameMode* GameMode)
+{
+
+}
+
+ERiseMatchEvent URiseMatchCondition::GetDependentEvents() const
+{
+	return ERiseMatchEvent::None;
+}
+
+float URiseMatchCondition::GetEvaluationInterval() const
+{
+	return 0.f;
+}
+
+ERiseMatchConditionResult URiseMatchCondition::Evaluate(const ARisePlayerState* Player) const
+{
+	return ERiseMatchConditionResult::None;
+}
+
+FString URiseMatchCondition::GetResultReason() const
+{
+	return TEXT("");
+}
+
+void URiseMatchCondition::GetPreloadClasses(TArray<FSoftObjectPath>& OutClassPaths) const
+{
+
+}
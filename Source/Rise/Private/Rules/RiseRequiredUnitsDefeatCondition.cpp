@@ -0,0 +1,63 @@
+#include "Rules/RiseRequiredUnitsDefeatCondition.h"
+
+#include "RiseGameMode.h"
+#include "RisePlayerState.h"
+#include "Subsystems/RiseOwnershipSubsystem.h"
+
+URiseRequiredUnitsDefeatCondition::URiseRequiredUnitsDefeatCondition()
+{
+	ActorCount = 1;
+}
+
+void URiseRequiredUnitsDefeatCondition::InitializeCondition(ARiseGameMode* GameMode)
+{
+	// Have the ownership index keep a count of the required actors so evaluating
+	// this condition is a single lookup. If the class is still being preloaded, it is
+	// registered on the first evaluation after it has loaded instead.
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(GameMode->GetWorld());
+	if (OwnershipSubsystem && ActorClass.Get())
+	{
+		OwnershipSubsystem->RegisterTrackedClass(ActorClass.Get());
+	}
+}
+
+ERiseMatchEvent URiseRequiredUnitsDefeatCondition::GetDependentEvents() const
+{
+	return ERiseMatchEvent::OwnershipChanged;
+}
+
+ERiseMatchConditionResult URiseRequiredUnitsDefeatCondition::Evaluate(const ARisePlayerState* Player) const
+{
+	// No actors of the class can have been spawned before it has loaded.
+	UClass* LoadedActorClass = ActorClass.Get();
+	if (!IsValid(Player) || !LoadedActorClass)
+	{
+		return ERiseMatchConditionResult::None;
+	}
+
+	URiseOwnershipSubsystem* OwnershipSubsystem = UWorld::GetSubsystem<URiseOwnershipSubsystem>(Player->GetWorld());
+	if (!OwnershipSubsystem)
+	{
+		return ERiseMatchConditionResult::None;
+	}
+
+	// Registering an already tracked class is a single lookup.
+	OwnershipSubsystem->RegisterTrackedClass(LoadedActorClass);
+
+	int32 TargetOwnedActors = OwnershipSubsystem->GetNumOwnedActorsOfClass(Player->GetPlayerIndex(), LoadedActorClass);
+
+	return TargetOwnedActors < ActorCount ? ERiseMatchConditionResult::Defeated : ERiseMatchConditionResult::None;
+}
+
+FString URiseRequiredUnitsDefeatCondition::GetResultReason() const
+{
+	return TEXT("The player does not control the necessary actors.");
+}
+
+void URiseRequiredUnitsDefeatCondition::GetPreloadClasses(TArray<FSoftObjectPath>& OutClassPaths) const
+{
+	if (!ActorClass.IsNull())
+	{
+		OutClassPaths.AddUnique(ActorClass.ToSoftObjectPath());
+	}
+}
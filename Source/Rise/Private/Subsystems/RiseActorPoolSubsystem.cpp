@@ -0,0 +1,142 @@
+#include "Subsystems/RiseActorPoolSubsystem.h"
+
+#include "GameFramework/Actor.h"
+
+#include "RiseLog.h"
+#include "Components/RiseActorComponent.h"
+
+bool URiseActorPoolSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (const FRisePooledClass& PooledClass : PooledClasses)
+	{
+		TSubclassOf<AActor> ActorClass = PooledClass.ActorClass.LoadSynchronous();
+		if (!ActorClass)
+		{
+			UE_LOG(LogRise, Warning, TEXT("Unable to load pooled class %s."), *PooledClass.ActorClass.ToString());
+			continue;
+		}
+
+		RegisterPooledClass(ActorClass, PooledClass.MaxPooledActors);
+	}
+}
+
+void URiseActorPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void URiseActorPoolSubsystem::RegisterPooledClass(TSubclassOf<AActor> ActorClass, int32 MaxPooledActors)
+{
+	if (!ActorClass)
+	{
+		return;
+	}
+
+	FRiseActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	Pool.MaxPooledActors = FMath::Max(MaxPooledActors, 0);
+
+	// Shrink the pool if the new limit is lower.
+	while (Pool.InactiveActors.Num() > Pool.MaxPooledActors)
+	{
+		Pool.InactiveActorsTickEnabled.RemoveAt(Pool.InactiveActorsTickEnabled.Num() - 1);
+
+		AActor* Actor = Pool.InactiveActors.Pop(false);
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+}
+
+bool URiseActorPoolSubsystem::IsPooledClass(TSubclassOf<AActor> ActorClass) const
+{
+	return Pools.Contains(ActorClass);
+}
+
+AActor* URiseActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform)
+{
+	FRiseActorPool* Pool = Pools.Find(ActorClass);
+	if (!Pool)
+	{
+		return nullptr;
+	}
+
+	while (!Pool->InactiveActors.IsEmpty())
+	{
+		bool bTickEnabled = Pool->InactiveActorsTickEnabled[Pool->InactiveActorsTickEnabled.Num() - 1];
+		Pool->InactiveActorsTickEnabled.RemoveAt(Pool->InactiveActorsTickEnabled.Num() - 1);
+
+		AActor* Actor = Pool->InactiveActors.Pop(false);
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		Actor->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+
+		// Restore the tick state the actor had, rather than waking up actors that never tick.
+		Actor->SetActorTickEnabled(bTickEnabled);
+
+		TInlineComponentArray<URiseActorComponent*> RiseComponents(Actor);
+		for (URiseActorComponent* RiseComponent : RiseComponents)
+		{
+			RiseComponent->OnAcquiredFromPool();
+		}
+
+		return Actor;
+	}
+
+	return nullptr;
+}
+
+bool URiseActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return false;
+	}
+
+	FRiseActorPool* Pool = Pools.Find(Actor->GetClass());
+	if (!Pool || Pool->InactiveActors.Num() >= Pool->MaxPooledActors)
+	{
+		Actor->Destroy();
+		return false;
+	}
+
+	// Let the components reset their state (clearing ownership, refilling resources, etc.).
+	TInlineComponentArray<URiseActorComponent*> RiseComponents(Actor);
+	for (URiseActorComponent* RiseComponent : RiseComponents)
+	{
+		RiseComponent->OnReleasedToPool();
+	}
+
+	Pool->InactiveActorsTickEnabled.Add(Actor->IsActorTickEnabled());
+
+	Actor->SetOwner(nullptr);
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	Pool->InactiveActors.Add(Actor);
+
+	UE_LOG(LogRise, Verbose, TEXT("Returned %s to the actor pool (%i pooled)."), *Actor->GetName(), Pool->InactiveActors.Num());
+
+	return true;
+}
+
+int32 URiseActorPoolSubsystem::GetNumPooledActors(TSubclassOf<AActor> ActorClass) const
+{
+	const FRiseActorPool* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->InactiveActors.Num() : 0;
+}
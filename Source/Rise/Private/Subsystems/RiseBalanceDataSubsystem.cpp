@@ -0,0 +1,241 @@
+#include "Subsystems/RiseBalanceDataSubsystem.h"
+
+#include "DataTableUtils.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "UObject/StructOnScope.h"
+
+#include "RiseLog.h"
+#include "Data/RiseRecipeData.h"
+
+/**
+ * Registered once for the module rather than per game instance, so multiple PIE instances do not
+ * fight over the command. Every running game instance is reloaded.
+ */
+static FAutoConsoleCommand ReloadBalanceDataCommand(
+	TEXT("Rise.ReloadBalanceData"),
+	TEXT("Reloads the balance data tables from their source files and applies the changes."),
+	FConsoleCommandDelegate::CreateStatic([]()
+	{
+		if (!GEngine)
+		{
+			return;
+		}
+
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			URiseBalanceDataSubsystem* BalanceData = UGameInstance::GetSubsystem<URiseBalanceDataSubsystem>(WorldContext.OwningGameInstance);
+			if (BalanceData)
+			{
+				BalanceData->ReloadBalanceData();
+			}
+		}
+	}),
+	ECVF_Cheat);
+
+void URiseBalanceDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Recipes can be authored as an asset or as a plain source file that ships with the game.
+	LoadedRecipeDataTable = RecipeDataTable.LoadSynchronous();
+	if (!LoadedRecipeDataTable && !RecipeDataSourceFile.IsEmpty())
+	{
+		LoadedRecipeDataTable = LoadDataTableFromCSV(FPaths::ProjectDir() / RecipeDataSourceFile, FRiseRecipeData::StaticStruct());
+	}
+
+	if (!LoadedRecipeDataTable)
+	{
+		UE_LOG(LogRise, Warning, TEXT("No recipe data is configured."));
+	}
+
+	// Compile the tables once up front so gameplay code never looks rows up by name.
+	LoadedStructureDataTable = StructureDataTable.LoadSynchronous();
+	if (!LoadedStructureDataTable)
+	{
+		UE_LOG(LogRise, Warning, TEXT("No structure data table is configured."));
+		return;
+	}
+
+	StructureData.Compile(LoadedStructureDataTable);
+
+#if WITH_EDITOR
+	// Pick up reimports and edits of the table while playing in the editor.
+	LoadedStructureDataTable->OnDataTableChanged().AddUObject(this, &URiseBalanceDataSubsystem::OnStructureDataTableChanged);
+#endif
+}
+
+void URiseBalanceDataSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	if (LoadedStructureDataTable)
+	{
+		LoadedStructureDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+#endif
+
+	LoadedStructureDataTable = nullptr;
+	LoadedRecipeDataTable = nullptr;
+	StructureData = FRiseStructureDataTable();
+	OnStructureDataChanged.Clear();
+	OnRecipeDataChanged.Clear();
+
+	Super::Deinitialize();
+}
+
+const FRiseStructureDataTable& URiseBalanceDataSubsystem::GetStructureData() const
+{
+	return StructureData;
+}
+
+const UDataTable* URiseBalanceDataSubsystem::GetRecipeDataTable() const
+{
+	return LoadedRecipeDataTable;
+}
+
+bool URiseBalanceDataSubsystem::ReloadBalanceData()
+{
+	bool bStructuresReloaded = ReloadStructureData(FPaths::ProjectDir() / StructureDataSourceFile);
+	bool bRecipesReloaded = ReloadRecipeData(FPaths::ProjectDir() / RecipeDataSourceFile);
+
+	return bStructuresReloaded && bRecipesReloaded;
+}
+
+bool URiseBalanceDataSubsystem::ReloadStructureData(const FString& Filename)
+{
+	UDataTable* DataTable = LoadDataTableFromCSV(Filename, FRiseStructureData::StaticStruct());
+	if (!DataTable)
+	{
+		return false;
+	}
+
+	ApplyStructureData(DataTable);
+
+	return true;
+}
+
+bool URiseBalanceDataSubsystem::ReloadRecipeData(const FString& Filename)
+{
+	UDataTable* DataTable = LoadDataTableFromCSV(Filename, FRiseRecipeData::StaticStruct());
+	if (!DataTable)
+	{
+		return false;
+	}
+
+	// Recipes are compiled per world against the resource registry, so listeners recompile them in full.
+	LoadedRecipeDataTable = DataTable;
+	OnRecipeDataChanged.Broadcast();
+
+	UE_LOG(LogRise, Log, TEXT("Reloaded recipe data: %i recipes."), DataTable->GetRowMap().Num());
+
+	return true;
+}
+
+UDataTable* URiseBalanceDataSubsystem::LoadDataTableFromCSV(const FString& Filename, UScriptStruct* RowStruct)
+{
+	FString CSV;
+	if (!FFileHelper::LoadFileToString(CSV, *Filename))
+	{
+		UE_LOG(LogRise, Error, TEXT("Unable to read balance data from %s."), *Filename);
+		return nullptr;
+	}
+
+	const FCsvParser Parser(CSV);
+	const FCsvParser::FRows& Rows = Parser.GetRows();
+	if (Rows.Num() < 2)
+	{
+		UE_LOG(LogRise, Error, TEXT("No balance data was read from %s."), *Filename);
+		return nullptr;
+	}
+
+	// Columns the struct does not know about are reported but do not prevent the import.
+	TArray<const FProperty*> ColumnProperties;
+	for (int32 Column = 1; Column < Rows[0].Num(); ++Column)
+	{
+		const FProperty* Property = FindFProperty<FProperty>(RowStruct, FName(Rows[0][Column]));
+		if (!Property)
+		{
+			UE_LOG(LogRise, Warning, TEXT("%s: Ignoring unknown column %s."), *Filename, Rows[0][Column]);
+		}
+
+		ColumnProperties.Add(Property);
+	}
+
+	UDataTable* DataTable = NewObject<UDataTable>(GetTransientPackage());
+	DataTable->RowStruct = RowStruct;
+
+	for (int32 RowIndex = 1; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const TArray<const TCHAR*>& Cells = Rows[RowIndex];
+		if (Cells.IsEmpty() || *Cells[0] == TEXT('\0'))
+		{
+			continue;
+		}
+
+		FStructOnScope Row(RowStruct);
+		for (int32 Column = 1; Column < Cells.Num() && Column <= ColumnProperties.Num(); ++Column)
+		{
+			const FProperty* Property = ColumnProperties[Column - 1];
+			if (!Property)
+			{
+				continue;
+			}
+
+			FString Error = DataTableUtils::AssignStringToProperty(Cells[Column], Property, Row.GetStructMemory());
+			if (!Error.IsEmpty())
+			{
+				UE_LOG(LogRise, Warning, TEXT("%s: Row %s, column %s: %s"), *Filename, Cells[0], *Property->GetName(), *Error);
+			}
+		}
+
+		DataTable->AddRow(FName(Cells[0]), *reinterpret_cast<const FTableRowBase*>(Row.GetStructMemory()));
+	}
+
+	if (DataTable->GetRowMap().Num() == 0)
+	{
+		UE_LOG(LogRise, Error, TEXT("No balance data was read from %s."), *Filename);
+		return nullptr;
+	}
+
+	return DataTable;
+}
+
+void URiseBalanceDataSubsystem::ApplyStructureData(const UDataTable* DataTable)
+{
+	FRiseStructureDataTable NewStructureData;
+	if (!NewStructureData.Compile(DataTable))
+	{
+		return;
+	}
+
+	// Only touch the rows that changed, so instances of unchanged structures are left alone.
+	TArray<FRiseStructureDataId> ChangedIds;
+	if (StructureData.ApplyRows(NewStructureData, ChangedIds))
+	{
+		UE_LOG(LogRise, Log, TEXT("Reloaded structure data: %i rows changed."), ChangedIds.Num());
+
+		if (!ChangedIds.IsEmpty())
+		{
+			OnStructureDataChanged.Broadcast(ChangedIds, false);
+		}
+
+		return;
+	}
+
+	UE_LOG(LogRise, Log, TEXT("Reloaded structure data: structure types or levels changed."));
+
+	StructureData = MoveTemp(NewStructureData);
+	OnStructureDataChanged.Broadcast(TArrayView<const FRiseStructureDataId>(), true);
+}
+
+#if WITH_EDITOR
+void URiseBalanceDataSubsystem::OnStructureDataTableChanged()
+{
+	ApplyStructureData(LoadedStructureDataTable);
+}
+#endif
@@ -0,0 +1,284 @@
+#include "Subsystems/RiseClassRegistrySubsystem.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Engine.h"
+
+#include "RiseLog.h"
+
+void URiseClassRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bIndexValid = false;
+	bReady = false;
+
+	// Cooked builds can answer most lookups from the manifest. The editor always uses the live
+	// registry so the results reflect the current content.
+	if (FPlatformProperties::RequiresCookedData())
+	{
+		FString ManifestFilename = FRiseClassManifest::GetDefaultFilename();
+		if (Manifest.LoadFromFile(ManifestFilename))
+		{
+			UE_LOG(LogRise, Log, TEXT("Loaded class manifest with %i base classes."), Manifest.ClassesByBaseClass.Num());
+		}
+		else
+		{
+			UE_LOG(LogRise, Warning, TEXT("No class manifest found at %s. Class lookups will use the asset registry."), *ManifestFilename);
+		}
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// Cooked builds load the registry up front. In the editor it is gathered in the background,
+	// so wait for it rather than scanning synchronously.
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &URiseClassRegistrySubsystem::OnAssetRegistryFilesLoaded);
+	}
+	else
+	{
+		OnAssetRegistryFilesLoaded();
+	}
+}
+
+void URiseClassRegistrySubsystem::Deinitialize()
+{
+	if (FModuleManager::Get().IsModuleLoaded(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::GetModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.OnFilesLoaded().RemoveAll(this);
+
+#if WITH_EDITOR
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+#endif
+	}
+
+	BlueprintClasses.Empty();
+	DerivedClassCache.Empty();
+	Manifest.ClassesByBaseClass.Empty();
+	OnReady.Clear();
+
+	Super::Deinitialize();
+}
+
+URiseClassRegistrySubsystem* URiseClassRegistrySubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<URiseClassRegistrySubsystem>() : nullptr;
+}
+
+bool URiseClassRegistrySubsystem::IsReady() const
+{
+	return bReady;
+}
+
+void URiseClassRegistrySubsystem::CallWhenReady(FSimpleDelegate Delegate)
+{
+	if (bReady)
+	{
+		Delegate.ExecuteIfBound();
+	}
+	else
+	{
+		OnReady.Add(MoveTemp(Delegate));
+	}
+}
+
+void URiseClassRegistrySubsystem::FindBlueprintClasses(const UClass* BaseClass, const TCHAR* ContentPath, const TCHAR* ClassNameHint, TArray<FSoftObjectPath>& OutClassPaths)
+{
+	if (!BaseClass)
+	{
+		return;
+	}
+
+	if (const TArray<FRiseClassManifestEntry>* ManifestClasses = Manifest.FindClasses(BaseClass))
+	{
+		for (const FRiseClassManifestEntry& Entry : *ManifestClasses)
+		{
+			if (ContentPath && !IsInContentPath(Entry.ClassPath.GetLongPackageName(), ContentPath))
+			{
+				continue;
+			}
+
+			if (ClassNameHint && !Entry.NameHint.Contains(ClassNameHint))
+			{
+				continue;
+			}
+
+			OutClassPaths.Add(Entry.ClassPath);
+		}
+
+		return;
+	}
+
+	if (!bReady)
+	{
+		UE_LOG(LogRise, Warning, TEXT("Looking up %s blueprints before the asset registry has finished loading. Results may be incomplete."), *BaseClass->GetName());
+	}
+
+	for (int32 ClassIndex : GetDerivedClassIndices(BaseClass))
+	{
+		const FSoftObjectPath& ClassPath = BlueprintClasses[ClassIndex].ClassPath;
+
+		if (ContentPath && !IsInContentPath(ClassPath.GetLongPackageName(), ContentPath))
+		{
+			continue;
+		}
+
+		if (ClassNameHint && !ClassPath.GetAssetName().Contains(ClassNameHint))
+		{
+			continue;
+		}
+
+		OutClassPaths.Add(ClassPath);
+	}
+}
+
+const TArray<FSoftClassPath>& URiseClassRegistrySubsystem::GetManifestBaseClasses() const
+{
+	return ManifestBaseClasses;
+}
+
+void URiseClassRegistrySubsystem::InvalidateIndex()
+{
+	bIndexValid = false;
+	DerivedClassCache.Empty();
+}
+
+void URiseClassRegistrySubsystem::BuildIndex()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// We are looking specifically for UBlueprints.
+	FARFilter Filter;
+	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+	Filter.bRecursiveClasses = true;
+
+	TArray<FAssetData> AssetList;
+	AssetRegistry.GetAssets(Filter, AssetList);
+
+	BlueprintClasses.Reset(AssetList.Num());
+
+	for (const FAssetData& Asset : AssetList)
+	{
+		// Determine whether the asset is a generated class.
+		FString GeneratedClassPathPtr = Asset.TagsAndValues.FindTag(TEXT("GeneratedClass")).AsString();
+		if (GeneratedClassPathPtr.IsEmpty())
+		{
+			continue;
+		}
+
+		// The class name and object path differs between editor and cooked builds.
+		// This will allow us to get the correct class name regardless of where this is called.
+		const FString ClassObjectPath = FPackageName::ExportTextPathToObjectPath(*GeneratedClassPathPtr);
+
+		FRiseBlueprintClassEntry& Entry = BlueprintClasses.AddDefaulted_GetRef();
+		Entry.ClassName = *FPackageName::ObjectPathToObjectName(ClassObjectPath);
+		Entry.ClassPath = FSoftObjectPath(ClassObjectPath);
+	}
+
+	// Keep lookups deterministic regardless of the order assets were discovered in.
+	BlueprintClasses.Sort([](const FRiseBlueprintClassEntry& A, const FRiseBlueprintClassEntry& B)
+	{
+		return A.ClassPath.ToString() < B.ClassPath.ToString();
+	});
+
+	DerivedClassCache.Empty();
+	bIndexValid = true;
+
+	UE_LOG(LogRise, Log, TEXT("Indexed %i blueprint classes."), BlueprintClasses.Num());
+}
+
+const TArray<int32>& URiseClassRegistrySubsystem::GetDerivedClassIndices(const UClass* BaseClass)
+{
+	if (!bIndexValid)
+	{
+		BuildIndex();
+	}
+
+	// Cache by class rather than by name, since different packages may contain classes with the same name.
+	if (const TArray<int32>* CachedIndices = DerivedClassCache.Find(BaseClass))
+	{
+		return *CachedIndices;
+	}
+
+	FName BaseClassName = BaseClass->GetFName();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TSet<FName> DerivedNames;
+	{
+		TArray<FName> BaseNames;
+		BaseNames.Add(BaseClassName);
+
+		TSet<FName> Excluded;
+		AssetRegistry.GetDerivedClassNames(BaseNames, Excluded, DerivedNames);
+	}
+
+	TArray<int32>& Indices = DerivedClassCache.Add(BaseClass);
+	for (int32 ClassIndex = 0; ClassIndex < BlueprintClasses.Num(); ++ClassIndex)
+	{
+		if (DerivedNames.Contains(BlueprintClasses[ClassIndex].ClassName))
+		{
+			Indices.Add(ClassIndex);
+		}
+	}
+
+	return Indices;
+}
+
+bool URiseClassRegistrySubsystem::IsInContentPath(const FString& PackageName, const TCHAR* ContentPath)
+{
+	int32 ContentPathLen = FCString::Strlen(ContentPath);
+	while (ContentPathLen > 0 && ContentPath[ContentPathLen - 1] == TEXT('/'))
+	{
+		--ContentPathLen;
+	}
+
+	if (PackageName.Len() < ContentPathLen || FCString::Strnicmp(*PackageName, ContentPath, ContentPathLen) != 0)
+	{
+		return false;
+	}
+
+	// Only match whole path components.
+	return PackageName.Len() == ContentPathLen || PackageName[ContentPathLen] == TEXT('/');
+}
+
+void URiseClassRegistrySubsystem::OnAssetRegistryFilesLoaded()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.OnFilesLoaded().RemoveAll(this);
+
+#if WITH_EDITOR
+	// Only listen for changes once discovery is done, otherwise every discovered asset would invalidate the index.
+	AssetRegistry.OnAssetAdded().AddUObject(this, &URiseClassRegistrySubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &URiseClassRegistrySubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetUpdated().AddUObject(this, &URiseClassRegistrySubsystem::OnAssetChanged);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &URiseClassRegistrySubsystem::OnAssetRenamed);
+#endif
+
+	// Anything indexed during discovery may be incomplete.
+	InvalidateIndex();
+	bReady = true;
+
+	OnReady.Broadcast();
+	OnReady.Clear();
+}
+
+#if WITH_EDITOR
+void URiseClassRegistrySubsystem::OnAssetChanged(const FAssetData& AssetData)
+{
+	if (AssetData.GetClass() && AssetData.GetClass()->IsChildOf(UBlueprint::StaticClass()))
+	{
+		InvalidateIndex();
+	}
+}
+
+void URiseClassRegistrySubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	OnAssetChanged(AssetData);
+}
+#endif
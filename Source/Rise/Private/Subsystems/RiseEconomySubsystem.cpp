@@ -0,0 +1,357 @@
+#include "Subsystems/RiseEconomySubsystem.h"
+
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+#include "RiseLog.h"
+#include "RisePlayerState.h"
+#include "RiseStats.h"
+#include "Components/RiseOwnableComponent.h"
+#include "Components/RiseResourceComponent.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+URiseEconomySubsystem::URiseEconomySubsystem()
+{
+	EconomyTickInterval = 0.25f;
+	MaxEconomyTicksPerFrame = 4;
+	EconomyTickAccumulator = 0.f;
+	ResourceReplicationBytes = 0;
+	ResourceReplicationStatTime = 0.f;
+}
+
+bool URiseEconomySubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseEconomySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ResourceRegistry = URiseResourceRegistrySubsystem::Get(&InWorld);
+}
+
+void URiseEconomySubsystem::Deinitialize()
+{
+	PendingResourceNodes.Empty();
+	PendingTransactions.Empty();
+	Stockpiles.Empty();
+	TickDeltas.Empty();
+	ChangedPlayers.Reset();
+	OnStockpileChanged.Clear();
+	OnEconomyTick.Clear();
+
+	Super::Deinitialize();
+}
+
+void URiseEconomySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if STATS
+	ResourceReplicationStatTime += DeltaTime;
+	if (ResourceReplicationStatTime >= 1.f)
+	{
+		SET_DWORD_STAT(STAT_RiseResourceReplicationBytesPerSecond, FMath::RoundToInt(ResourceReplicationBytes / ResourceReplicationStatTime));
+
+		ResourceReplicationBytes = 0;
+		ResourceReplicationStatTime = 0.f;
+	}
+#endif
+
+	if (EconomyTickInterval <= 0.f)
+	{
+		EconomyTick();
+		return;
+	}
+
+	EconomyTickAccumulator += DeltaTime;
+
+	int32 NumTicks = 0;
+	while (EconomyTickAccumulator >= EconomyTickInterval && NumTicks < MaxEconomyTicksPerFrame)
+	{
+		EconomyTickAccumulator -= EconomyTickInterval;
+		++NumTicks;
+
+		EconomyTick();
+	}
+
+	// Drop any time we could not catch up on rather than spiralling after a long hitch.
+	if (NumTicks == MaxEconomyTicksPerFrame)
+	{
+		EconomyTickAccumulator = FMath::Min(EconomyTickAccumulator, EconomyTickInterval);
+	}
+}
+
+TStatId URiseEconomySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URiseEconomySubsystem, STATGROUP_Rise);
+}
+
+float URiseEconomySubsystem::GetEconomyTickInterval() const
+{
+	return EconomyTickInterval;
+}
+
+void URiseEconomySubsystem::QueueResourceNode(URiseResourceComponent* ResourceComponent)
+{
+	if (ResourceComponent)
+	{
+		PendingResourceNodes.Add(ResourceComponent);
+	}
+}
+
+void URiseEconomySubsystem::RecordResourceReplication(int32 Bytes)
+{
+#if STATS
+	INC_DWORD_STAT(STAT_RiseResourceReplicationUpdates);
+
+	// The update is sent to every client the node is relevant to. Resource nodes are visible to every
+	// player, so count every connection; this overestimates nodes that are net culled for some clients.
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+
+	ResourceReplicationBytes += Bytes * NumConnections;
+#endif
+}
+
+FRiseResourceAmount URiseEconomySubsystem::GetResourceAmount(uint8 PlayerIndex, FRiseResourceId ResourceId) const
+{
+	if (!Stockpiles.IsValidIndex(PlayerIndex) || !Stockpiles[PlayerIndex].IsValidIndex(ResourceId))
+	{
+		return 0;
+	}
+
+	return Stockpiles[PlayerIndex][ResourceId];
+}
+
+TArrayView<const FRiseResourceAmount> URiseEconomySubsystem::GetStockpile(uint8 PlayerIndex) const
+{
+	if (!Stockpiles.IsValidIndex(PlayerIndex))
+	{
+		return TArrayView<const FRiseResourceAmount>();
+	}
+
+	return Stockpiles[PlayerIndex];
+}
+
+void URiseEconomySubsystem::QueueTransaction(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE || !ResourceRegistry || ResourceId >= ResourceRegistry->GetNumResourceTypes() || Amount == 0)
+	{
+		return;
+	}
+
+	PendingTransactions.Add({ PlayerIndex, ResourceId, Amount });
+}
+
+bool URiseEconomySubsystem::TrySpend(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE || !ResourceRegistry || ResourceId >= ResourceRegistry->GetNumResourceTypes() || Amount < 0)
+	{
+		return false;
+	}
+
+	if (GetResourceAmount(PlayerIndex, ResourceId) < Amount)
+	{
+		return false;
+	}
+
+	ApplyToStockpile(PlayerIndex, ResourceId, -Amount);
+
+	return true;
+}
+
+void URiseEconomySubsystem::Deposit(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE || !ResourceRegistry || ResourceId >= ResourceRegistry->GetNumResourceTypes() || Amount <= 0)
+	{
+		return;
+	}
+
+	ApplyToStockpile(PlayerIndex, ResourceId, Amount);
+}
+
+void URiseEconomySubsystem::ReleasePlayerIndex(uint8 PlayerIndex)
+{
+	PendingTransactions.RemoveAll([PlayerIndex](const FRiseResourceTransaction& Transaction)
+	{
+		return Transaction.PlayerIndex == PlayerIndex;
+	});
+
+	if (Stockpiles.IsValidIndex(PlayerIndex))
+	{
+		Stockpiles[PlayerIndex].Empty();
+		TickDeltas[PlayerIndex].Empty();
+	}
+
+	ChangedPlayers.Remove(PlayerIndex);
+}
+
+void URiseEconomySubsystem::EconomyTick()
+{
+	// Only the server runs the economy. Clients receive the results through their player states.
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	// Resolving a node may deplete it and queue further work, so swap the list out first.
+	TArray<URiseResourceComponent*> ResourceNodes = MoveTemp(PendingResourceNodes);
+	PendingResourceNodes.Reset();
+
+	for (URiseResourceComponent* ResourceComponent : ResourceNodes)
+	{
+		if (IsValid(ResourceComponent))
+		{
+			TArray<FRiseResourceGatherResult> GatherResults = ResourceComponent->ResolvePendingExtractions();
+			CreditGatherers(ResourceComponent, GatherResults);
+		}
+	}
+
+	for (const FRiseResourceTransaction& Transaction : PendingTransactions)
+	{
+		ApplyToStockpile(Transaction.PlayerIndex, Transaction.ResourceId, Transaction.Amount);
+	}
+	PendingTransactions.Reset();
+
+	OnEconomyTick.Broadcast();
+
+	PublishDeltas();
+}
+
+TArray<FRiseResourceAmount>& URiseEconomySubsystem::GetOrAddStockpile(uint8 PlayerIndex)
+{
+	if (!Stockpiles.IsValidIndex(PlayerIndex))
+	{
+		Stockpiles.SetNum(PlayerIndex + 1);
+		TickDeltas.SetNum(PlayerIndex + 1);
+	}
+
+	TArray<FRiseResourceAmount>& Stockpile = Stockpiles[PlayerIndex];
+	if (Stockpile.Num() != ResourceRegistry->GetNumResourceTypes())
+	{
+		Stockpile.SetNumZeroed(ResourceRegistry->GetNumResourceTypes());
+		TickDeltas[PlayerIndex].SetNumZeroed(ResourceRegistry->GetNumResourceTypes());
+	}
+
+	return Stockpile;
+}
+
+FRiseResourceAmount URiseEconomySubsystem::ApplyToStockpile(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount)
+{
+	TArray<FRiseResourceAmount>& Stockpile = GetOrAddStockpile(PlayerIndex);
+
+	// Expenses never take a stockpile below zero.
+	FRiseResourceAmount AppliedAmount = FMath::Max(Amount, -Stockpile[ResourceId]);
+	if (AppliedAmount == 0)
+	{
+		return 0;
+	}
+
+	Stockpile[ResourceId] += AppliedAmount;
+	TickDeltas[PlayerIndex][ResourceId] += AppliedAmount;
+	ChangedPlayers.Add(PlayerIndex);
+
+	return AppliedAmount;
+}
+
+void URiseEconomySubsystem::CreditGatherers(const URiseResourceComponent* ResourceComponent, TArrayView<const FRiseResourceGatherResult> GatherResults)
+{
+	if (GatherResults.IsEmpty())
+	{
+		return;
+	}
+
+	FRiseResourceId ResourceId = ResourceComponent->GetResourceId();
+	if (ResourceId == RISE_RESOURCE_ID_NONE)
+	{
+		return;
+	}
+
+	for (const FRiseResourceGatherResult& GatherResult : GatherResults)
+	{
+		URiseOwnableComponent* OwnableComponent = GatherResult.Gatherer ? GatherResult.Gatherer->FindComponentByClass<URiseOwnableComponent>() : nullptr;
+		ARisePlayerState* PlayerOwner = OwnableComponent ? OwnableComponent->GetPlayerOwner() : nullptr;
+		if (PlayerOwner)
+		{
+			QueueTransaction(PlayerOwner->GetPlayerIndex(), ResourceId, GatherResult.FixedGatheredAmount);
+		}
+	}
+}
+
+void URiseEconomySubsystem::PublishDeltas()
+{
+	if (ChangedPlayers.Num() == 0)
+	{
+		return;
+	}
+
+	// Player states are looked up once per tick rather than once per change.
+	TArray<ARisePlayerState*, TInlineAllocator<8>> PlayerStatesByIndex;
+	AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (GameState)
+	{
+		for (APlayerState* BasePlayerState : GameState->PlayerArray)
+		{
+			ARisePlayerState* PlayerState = Cast<ARisePlayerState>(BasePlayerState);
+			if (IsValid(PlayerState) && PlayerState->GetPlayerIndex() != ARisePlayerState::PLAYER_INDEX_NONE)
+			{
+				if (PlayerState->GetPlayerIndex() >= PlayerStatesByIndex.Num())
+				{
+					PlayerStatesByIndex.SetNumZeroed(PlayerState->GetPlayerIndex() + 1);
+				}
+
+				PlayerStatesByIndex[PlayerState->GetPlayerIndex()] = PlayerState;
+			}
+		}
+	}
+
+	TArray<FRiseResourceDelta> Deltas;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < Stockpiles.Num(); ++PlayerIndex)
+	{
+		if (!ChangedPlayers.Contains(PlayerIndex))
+		{
+			continue;
+		}
+
+		TArray<FRiseResourceAmount>& PlayerDeltas = TickDeltas[PlayerIndex];
+		const TArray<FRiseResourceAmount>& Stockpile = Stockpiles[PlayerIndex];
+
+		Deltas.Reset();
+		for (int32 ResourceId = 0; ResourceId < PlayerDeltas.Num(); ++ResourceId)
+		{
+			if (PlayerDeltas[ResourceId] == 0)
+			{
+				continue;
+			}
+
+			FRiseResourceDelta& Delta = Deltas.AddDefaulted_GetRef();
+			Delta.ResourceId = ResourceId;
+			Delta.ResourceType = ResourceRegistry->GetResourceType(ResourceId);
+			Delta.FixedDelta = PlayerDeltas[ResourceId];
+			Delta.FixedNewAmount = Stockpile[ResourceId];
+			Delta.Delta = FRiseResourceMath::ToFloat(Delta.FixedDelta);
+			Delta.NewAmount = FRiseResourceMath::ToFloat(Delta.FixedNewAmount);
+
+			PlayerDeltas[ResourceId] = 0;
+		}
+
+		// Income and expenses within the tick may have cancelled out.
+		if (Deltas.IsEmpty())
+		{
+			continue;
+		}
+
+		OnStockpileChanged.Broadcast(PlayerIndex, Deltas);
+
+		if (PlayerStatesByIndex.IsValidIndex(PlayerIndex) && PlayerStatesByIndex[PlayerIndex])
+		{
+			PlayerStatesByIndex[PlayerIndex]->SetResourceStockpile(Stockpile, Deltas);
+		}
+	}
+
+	ChangedPlayers.Reset();
+}
@@ -0,0 +1,407 @@
+#include "Subsystems/RiseOwnershipSubsystem.h"
+
+#include "RisePlayerState.h"
+#include "Components/RiseOwnableComponent.h"
+
+bool URiseOwnershipSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	// Ownership only exists in worlds that are being played.
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseOwnershipSubsystem::Deinitialize()
+{
+	for (FRiseOwnedActorSet& Set : PlayerSets)
+	{
+		for (URiseOwnableComponent* OwnableComponent : Set.Components)
+		{
+			OwnableComponent->OwnershipSlot = INDEX_NONE;
+		}
+	}
+
+	for (URiseOwnableComponent* OwnableComponent : UnindexedSet.Components)
+	{
+		OwnableComponent->OwnershipSlot = INDEX_NONE;
+	}
+
+	for (FRiseInitialOwnerBucket& Bucket : InitialOwnerBuckets)
+	{
+		for (URiseOwnableComponent* OwnableComponent : Bucket.Components)
+		{
+			OwnableComponent->InitialOwnerSlot = INDEX_NONE;
+		}
+	}
+
+	PlayerSets.Empty();
+	UnindexedSet = FRiseOwnedActorSet();
+	TrackedClasses.Empty();
+	TrackedClassIds.Empty();
+	TrackedClassMatches.Empty();
+	InitialOwnerBuckets.Empty();
+
+	Super::Deinitialize();
+}
+
+void URiseOwnershipSubsystem::UpdateOwnable(URiseOwnableComponent* OwnableComponent)
+{
+	if (!OwnableComponent)
+	{
+		return;
+	}
+
+	ARisePlayerState* PlayerOwner = OwnableComponent->GetPlayerOwner();
+	if (!PlayerOwner)
+	{
+		RemoveFromSet(OwnableComponent);
+		return;
+	}
+
+	uint8 PlayerIndex = PlayerOwner->GetPlayerIndex();
+
+	// The component is already in the correct set.
+	if (OwnableComponent->OwnershipSlot != INDEX_NONE && OwnableComponent->OwnershipSetIndex == PlayerIndex)
+	{
+		return;
+	}
+
+	RemoveFromSet(OwnableComponent);
+	AddToSet(OwnableComponent, PlayerIndex);
+}
+
+void URiseOwnershipSubsystem::UnregisterOwnable(URiseOwnableComponent* OwnableComponent)
+{
+	if (!OwnableComponent)
+	{
+		return;
+	}
+
+	RemoveFromSet(OwnableComponent);
+}
+
+void URiseOwnershipSubsystem::NotifyPlayerIndexChanged(ARisePlayerState* PlayerState, uint8 OldPlayerIndex)
+{
+	if (!PlayerState || PlayerState->GetPlayerIndex() == OldPlayerIndex)
+	{
+		return;
+	}
+
+	uint8 NewPlayerIndex = PlayerState->GetPlayerIndex();
+
+	// Players without an index share the unindexed set, so only move the components
+	// that actually belong to this player. This set is normally empty.
+	if (OldPlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		for (int32 Slot = UnindexedSet.Components.Num() - 1; Slot >= 0; --Slot)
+		{
+			URiseOwnableComponent* OwnableComponent = UnindexedSet.Components[Slot];
+			if (OwnableComponent->GetPlayerOwner() == PlayerState)
+			{
+				RemoveFromSet(OwnableComponent);
+				AddToSet(OwnableComponent, NewPlayerIndex);
+			}
+		}
+
+		return;
+	}
+
+	if (!PlayerSets.IsValidIndex(OldPlayerIndex))
+	{
+		return;
+	}
+
+	// Move the whole set over rather than re-adding each component individually.
+	FRiseOwnedActorSet OldSet = MoveTemp(PlayerSets[OldPlayerIndex]);
+	PlayerSets[OldPlayerIndex] = FRiseOwnedActorSet();
+
+	for (URiseOwnableComponent* OwnableComponent : OldSet.Components)
+	{
+		OwnableComponent->OwnershipSlot = INDEX_NONE;
+		AddToSet(OwnableComponent, NewPlayerIndex);
+	}
+}
+
+void URiseOwnershipSubsystem::ReleasePlayerIndex(uint8 PlayerIndex)
+{
+	if (!PlayerSets.IsValidIndex(PlayerIndex))
+	{
+		return;
+	}
+
+	FRiseOwnedActorSet& Set = PlayerSets[PlayerIndex];
+	bool bHadActors = !Set.Components.IsEmpty();
+
+	for (URiseOwnableComponent* OwnableComponent : Set.Components)
+	{
+		OwnableComponent->OwnershipSlot = INDEX_NONE;
+		OwnableComponent->OwnershipSetIndex = ARisePlayerState::PLAYER_INDEX_NONE;
+	}
+
+	Set = FRiseOwnedActorSet();
+
+	if (bHadActors)
+	{
+		OnOwnedActorsChanged.Broadcast(PlayerIndex);
+	}
+}
+
+TArrayView<AActor* const> URiseOwnershipSubsystem::GetOwnedActors(uint8 PlayerIndex) const
+{
+	const FRiseOwnedActorSet* Set = FindSet(PlayerIndex);
+	if (!Set)
+	{
+		return TArrayView<AActor* const>();
+	}
+
+	return Set->Actors;
+}
+
+TArrayView<URiseOwnableComponent* const> URiseOwnershipSubsystem::GetOwnedComponents(uint8 PlayerIndex) const
+{
+	const FRiseOwnedActorSet* Set = FindSet(PlayerIndex);
+	if (!Set)
+	{
+		return TArrayView<URiseOwnableComponent* const>();
+	}
+
+	return Set->Components;
+}
+
+int32 URiseOwnershipSubsystem::GetNumOwnedActors(uint8 PlayerIndex) const
+{
+	const FRiseOwnedActorSet* Set = FindSet(PlayerIndex);
+	return Set ? Set->Actors.Num() : 0;
+}
+
+int32 URiseOwnershipSubsystem::RegisterTrackedClass(TSubclassOf<AActor> ActorClass)
+{
+	if (!ActorClass)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* ExistingId = TrackedClassIds.Find(ActorClass))
+	{
+		return *ExistingId;
+	}
+
+	int32 TrackedClassId = TrackedClasses.Add(ActorClass);
+	TrackedClassIds.Add(ActorClass, TrackedClassId);
+
+	// The cached matches no longer account for the new class.
+	TrackedClassMatches.Empty();
+
+	// Count the actors that are already owned. This is the only time the sets are walked.
+	auto CountSet = [&](FRiseOwnedActorSet& Set)
+	{
+		Set.TrackedClassCounts.SetNumZeroed(TrackedClasses.Num());
+
+		for (const URiseOwnableComponent* OwnableComponent : Set.Components)
+		{
+			const AActor* Actor = OwnableComponent->GetOwner();
+			if (Actor && Actor->GetClass()->IsChildOf(ActorClass))
+			{
+				++Set.TrackedClassCounts[TrackedClassId];
+			}
+		}
+	};
+
+	for (FRiseOwnedActorSet& Set : PlayerSets)
+	{
+		CountSet(Set);
+	}
+	CountSet(UnindexedSet);
+
+	return TrackedClassId;
+}
+
+int32 URiseOwnershipSubsystem::GetNumOwnedActorsOfClass(uint8 PlayerIndex, TSubclassOf<AActor> ActorClass) const
+{
+	const int32* TrackedClassId = TrackedClassIds.Find(ActorClass);
+	if (!TrackedClassId)
+	{
+		return 0;
+	}
+
+	const FRiseOwnedActorSet* Set = FindSet(PlayerIndex);
+	if (!Set || !Set->TrackedClassCounts.IsValidIndex(*TrackedClassId))
+	{
+		return 0;
+	}
+
+	return Set->TrackedClassCounts[*TrackedClassId];
+}
+
+void URiseOwnershipSubsystem::RegisterInitialOwnable(URiseOwnableComponent* OwnableComponent)
+{
+	if (!OwnableComponent || OwnableComponent->InitialOwnerSlot != INDEX_NONE)
+	{
+		return;
+	}
+
+	uint8 PlayerIndex = OwnableComponent->GetInitialOwnerPlayerIndex();
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return;
+	}
+
+	if (!InitialOwnerBuckets.IsValidIndex(PlayerIndex))
+	{
+		InitialOwnerBuckets.SetNum(PlayerIndex + 1);
+	}
+
+	OwnableComponent->InitialOwnerSlot = InitialOwnerBuckets[PlayerIndex].Components.Add(OwnableComponent);
+}
+
+void URiseOwnershipSubsystem::UnregisterInitialOwnable(URiseOwnableComponent* OwnableComponent)
+{
+	if (!OwnableComponent)
+	{
+		return;
+	}
+
+	int32 Slot = OwnableComponent->InitialOwnerSlot;
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray<URiseOwnableComponent*>& Components = InitialOwnerBuckets[OwnableComponent->GetInitialOwnerPlayerIndex()].Components;
+	check(Components.IsValidIndex(Slot) && Components[Slot] == OwnableComponent);
+
+	// Swap the last component into the freed slot to keep the bucket dense.
+	Components.RemoveAtSwap(Slot, 1, false);
+
+	if (Components.IsValidIndex(Slot))
+	{
+		Components[Slot]->InitialOwnerSlot = Slot;
+	}
+
+	OwnableComponent->InitialOwnerSlot = INDEX_NONE;
+}
+
+TArrayView<URiseOwnableComponent* const> URiseOwnershipSubsystem::GetInitiallyOwnedComponents(uint8 PlayerIndex) const
+{
+	if (!InitialOwnerBuckets.IsValidIndex(PlayerIndex))
+	{
+		return TArrayView<URiseOwnableComponent* const>();
+	}
+
+	return InitialOwnerBuckets[PlayerIndex].Components;
+}
+
+FRiseOwnedActorSet& URiseOwnershipSubsystem::GetOrAddSet(uint8 PlayerIndex)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return UnindexedSet;
+	}
+
+	if (!PlayerSets.IsValidIndex(PlayerIndex))
+	{
+		PlayerSets.SetNum(PlayerIndex + 1);
+	}
+
+	return PlayerSets[PlayerIndex];
+}
+
+const FRiseOwnedActorSet* URiseOwnershipSubsystem::FindSet(uint8 PlayerIndex) const
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		// The unindexed set mixes players together, so it is never exposed.
+		return nullptr;
+	}
+
+	return PlayerSets.IsValidIndex(PlayerIndex) ? &PlayerSets[PlayerIndex] : nullptr;
+}
+
+void URiseOwnershipSubsystem::AddToSet(URiseOwnableComponent* OwnableComponent, uint8 PlayerIndex)
+{
+	check(OwnableComponent->OwnershipSlot == INDEX_NONE);
+
+	FRiseOwnedActorSet& Set = GetOrAddSet(PlayerIndex);
+
+	OwnableComponent->OwnershipSetIndex = PlayerIndex;
+	OwnableComponent->OwnershipSlot = Set.Components.Add(OwnableComponent);
+	Set.Actors.Add(OwnableComponent->GetOwner());
+
+	UpdateTrackedClassCounts(Set, OwnableComponent->GetOwner(), 1);
+
+	if (PlayerIndex != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		OnOwnedActorsChanged.Broadcast(PlayerIndex);
+	}
+}
+
+void URiseOwnershipSubsystem::RemoveFromSet(URiseOwnableComponent* OwnableComponent)
+{
+	int32 Slot = OwnableComponent->OwnershipSlot;
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	FRiseOwnedActorSet& Set = GetOrAddSet(OwnableComponent->OwnershipSetIndex);
+	check(Set.Components.IsValidIndex(Slot) && Set.Components[Slot] == OwnableComponent);
+
+	UpdateTrackedClassCounts(Set, OwnableComponent->GetOwner(), -1);
+
+	// Swap the last component into the freed slot to keep the set dense.
+	Set.Components.RemoveAtSwap(Slot, 1, false);
+	Set.Actors.RemoveAtSwap(Slot, 1, false);
+
+	if (Set.Components.IsValidIndex(Slot))
+	{
+		Set.Components[Slot]->OwnershipSlot = Slot;
+	}
+
+	uint8 PlayerIndex = OwnableComponent->OwnershipSetIndex;
+
+	OwnableComponent->OwnershipSlot = INDEX_NONE;
+	OwnableComponent->OwnershipSetIndex = ARisePlayerState::PLAYER_INDEX_NONE;
+
+	if (PlayerIndex != ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		OnOwnedActorsChanged.Broadcast(PlayerIndex);
+	}
+}
+
+void URiseOwnershipSubsystem::UpdateTrackedClassCounts(FRiseOwnedActorSet& Set, const AActor* Actor, int32 Delta)
+{
+	if (!Actor || TrackedClasses.IsEmpty())
+	{
+		return;
+	}
+
+	const TArray<int32>& Matches = GetTrackedClassMatches(Actor->GetClass());
+	if (Matches.IsEmpty())
+	{
+		return;
+	}
+
+	Set.TrackedClassCounts.SetNumZeroed(TrackedClasses.Num());
+
+	for (int32 TrackedClassId : Matches)
+	{
+		Set.TrackedClassCounts[TrackedClassId] += Delta;
+	}
+}
+
+const TArray<int32>& URiseOwnershipSubsystem::GetTrackedClassMatches(const UClass* ActorClass)
+{
+	if (const TArray<int32>* CachedMatches = TrackedClassMatches.Find(ActorClass))
+	{
+		return *CachedMatches;
+	}
+
+	TArray<int32>& Matches = TrackedClassMatches.Add(ActorClass);
+	for (int32 TrackedClassId = 0; TrackedClassId < TrackedClasses.Num(); ++TrackedClassId)
+	{
+		if (ActorClass->IsChildOf(TrackedClasses[TrackedClassId]))
+		{
+			Matches.Add(TrackedClassId);
+		}
+	}
+
+	return Matches;
+}
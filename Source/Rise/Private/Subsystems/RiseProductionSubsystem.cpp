@@ -0,0 +1,496 @@
+#include "Subsystems/RiseProductionSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+#include "RiseLog.h"
+#include "RisePlayerState.h"
+#include "Subsystems/RiseBalanceDataSubsystem.h"
+#include "Subsystems/RiseEconomySubsystem.h"
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+bool URiseProductionSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseProductionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EconomySubsystem = Cast<URiseEconomySubsystem>(Collection.InitializeDependency(URiseEconomySubsystem::StaticClass()));
+	if (EconomySubsystem)
+	{
+		EconomyTickHandle = EconomySubsystem->OnEconomyTick.AddUObject(this, &URiseProductionSubsystem::OnEconomyTick);
+	}
+
+	URiseBalanceDataSubsystem* BalanceData = UGameInstance::GetSubsystem<URiseBalanceDataSubsystem>(GetWorld()->GetGameInstance());
+	if (BalanceData)
+	{
+		RecipeDataChangedHandle = BalanceData->OnRecipeDataChanged.AddUObject(this, &URiseProductionSubsystem::CompileRecipes);
+	}
+}
+
+void URiseProductionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Recipes refer to resources by type, so they can only be compiled once the registry has assigned the ids.
+	CompileRecipes();
+}
+
+void URiseProductionSubsystem::Deinitialize()
+{
+	if (EconomySubsystem)
+	{
+		EconomySubsystem->OnEconomyTick.Remove(EconomyTickHandle);
+		EconomySubsystem = nullptr;
+	}
+
+	URiseBalanceDataSubsystem* BalanceData = UGameInstance::GetSubsystem<URiseBalanceDataSubsystem>(GetWorld()->GetGameInstance());
+	if (BalanceData)
+	{
+		BalanceData->OnRecipeDataChanged.Remove(RecipeDataChangedHandle);
+	}
+
+	RecipeGraph = FRiseRecipeGraph();
+	RecipeProducers.Empty();
+	ProducerLocations.Empty();
+	FreeProducerIds.Empty();
+	AllocatedProducerIds.Empty();
+	PlayerProduction.Empty();
+	DueCycles.Empty();
+
+	Super::Deinitialize();
+}
+
+const FRiseRecipeGraph& URiseProductionSubsystem::GetRecipeGraph() const
+{
+	return RecipeGraph;
+}
+
+int32 URiseProductionSubsystem::RegisterProducer(uint8 PlayerIndex, FName RecipeName, FRiseResourceAmount Efficiency)
+{
+	if (PlayerIndex == ARisePlayerState::PLAYER_INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 RecipeIndex = RecipeGraph.FindRecipeIndex(RecipeName);
+	if (RecipeIndex == INDEX_NONE)
+	{
+		UE_LOG(LogRise, Warning, TEXT("Unable to register a producer for unknown recipe %s."), *RecipeName.ToString());
+		return INDEX_NONE;
+	}
+
+	int32 ProducerId = FreeProducerIds.Num() > 0 ? FreeProducerIds.Pop(false) : ProducerLocations.AddDefaulted();
+	if (!AllocatedProducerIds.IsValidIndex(ProducerId))
+	{
+		AllocatedProducerIds.Add(false);
+	}
+
+	AllocatedProducerIds[ProducerId] = true;
+	AddProducer(ProducerId, RecipeIndex, PlayerIndex, FMath::Max(Efficiency, 0), 0);
+
+	return ProducerId;
+}
+
+void URiseProductionSubsystem::UnregisterProducer(int32 ProducerId)
+{
+	if (!AllocatedProducerIds.IsValidIndex(ProducerId) || !AllocatedProducerIds[ProducerId])
+	{
+		return;
+	}
+
+	// The producer may already have been stopped, but the id is only reused once its owner lets go of it.
+	RemoveProducer(ProducerId);
+
+	AllocatedProducerIds[ProducerId] = false;
+	FreeProducerIds.Add(ProducerId);
+}
+
+void URiseProductionSubsystem::ReleasePlayerIndex(uint8 PlayerIndex)
+{
+	if (!PlayerProduction.IsValidIndex(PlayerIndex))
+	{
+		return;
+	}
+
+	for (FRiseRecipeProducers& Producers : RecipeProducers)
+	{
+		for (int32 Slot = Producers.ProducerIds.Num() - 1; Slot >= 0; --Slot)
+		{
+			if (Producers.PlayerIndices[Slot] == PlayerIndex)
+			{
+				RemoveProducer(Producers.ProducerIds[Slot]);
+			}
+		}
+	}
+
+	PlayerProduction[PlayerIndex] = FRisePlayerProduction();
+}
+
+void URiseProductionSubsystem::SetProducerEfficiency(int32 ProducerId, FRiseResourceAmount Efficiency)
+{
+	if (!ProducerLocations.IsValidIndex(ProducerId) || ProducerLocations[ProducerId].RecipeIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	int32 RecipeIndex = ProducerLocations[ProducerId].RecipeIndex;
+	int32 Slot = ProducerLocations[ProducerId].Slot;
+
+	FRiseRecipeProducers& Producers = RecipeProducers[RecipeIndex];
+	uint8 PlayerIndex = Producers.PlayerIndices[Slot];
+
+	Efficiency = FMath::Max(Efficiency, 0);
+
+	AdjustRates(PlayerIndex, RecipeIndex, Producers.Efficiencies[Slot], -1);
+	AdjustRates(PlayerIndex, RecipeIndex, Efficiency, 1);
+
+	Producers.Efficiencies[Slot] = Efficiency;
+}
+
+FRiseThroughputReport URiseProductionSubsystem::GetThroughputLimit(uint8 PlayerIndex, FRiseResourceId ResourceId) const
+{
+	FRiseThroughputReport Report;
+	Report.ResourceId = ResourceId;
+	Report.LimitingResource = ResourceId;
+	Report.Chain.Add(ResourceId);
+
+	const FRisePlayerProduction* Production = PlayerProduction.IsValidIndex(PlayerIndex) ? &PlayerProduction[PlayerIndex] : nullptr;
+	if (Production && Production->SupplyRates.IsValidIndex(ResourceId))
+	{
+		Report.SupplyPerMinute = RateToUnitsPerMinute(Production->SupplyRates[ResourceId]);
+		Report.DemandPerMinute = RateToUnitsPerMinute(Production->DemandRates[ResourceId]);
+	}
+
+	if (RecipeGraph.GetProducingRecipes(ResourceId).IsEmpty())
+	{
+		Report.Limit = ERiseThroughputLimit::Gathered;
+		return Report;
+	}
+
+	// Follow the worst supplied input up the chain until the producers of a resource have everything they need.
+	FRiseResourceId CurrentResource = ResourceId;
+	while (true)
+	{
+		if (!Production || !Production->SupplyRates.IsValidIndex(CurrentResource) || Production->SupplyRates[CurrentResource] == 0)
+		{
+			Report.Limit = ERiseThroughputLimit::NoProducers;
+			Report.LimitingResource = CurrentResource;
+			return Report;
+		}
+
+		FRiseResourceId WorstInput = RISE_RESOURCE_ID_NONE;
+		double WorstSupplyRatio = 1.0;
+
+		for (int32 RecipeIndex : RecipeGraph.GetProducingRecipes(CurrentResource))
+		{
+			if (Production->NumProducers[RecipeIndex] == 0)
+			{
+				continue;
+			}
+
+			for (const FRiseRecipeAmount& Input : RecipeGraph.GetRecipe(RecipeIndex).Inputs)
+			{
+				double SupplyRatio;
+				if (Production->StarvedInputs[RecipeIndex] == Input.ResourceId)
+				{
+					// The input ran out on the last evaluation, whatever the capacity says.
+					SupplyRatio = 0.0;
+				}
+				else if (!RecipeGraph.GetProducingRecipes(Input.ResourceId).IsEmpty() && Production->DemandRates[Input.ResourceId] > 0)
+				{
+					SupplyRatio = static_cast<double>(Production->SupplyRates[Input.ResourceId]) / Production->DemandRates[Input.ResourceId];
+				}
+				else
+				{
+					// Gathered inputs only limit production once they actually run out.
+					continue;
+				}
+
+				if (SupplyRatio < WorstSupplyRatio)
+				{
+					WorstInput = Input.ResourceId;
+					WorstSupplyRatio = SupplyRatio;
+				}
+			}
+		}
+
+		// Production chains may loop back on themselves. Stop at the first repeated resource.
+		if (WorstInput == RISE_RESOURCE_ID_NONE || Report.Chain.Contains(WorstInput))
+		{
+			Report.Limit = CurrentResource == ResourceId ? ERiseThroughputLimit::ProducerCapacity : ERiseThroughputLimit::InputCapacity;
+			Report.LimitingResource = CurrentResource;
+			return Report;
+		}
+
+		Report.Chain.Add(WorstInput);
+
+		if (RecipeGraph.GetProducingRecipes(WorstInput).IsEmpty())
+		{
+			Report.Limit = ERiseThroughputLimit::InputStock;
+			Report.LimitingResource = WorstInput;
+			return Report;
+		}
+
+		CurrentResource = WorstInput;
+	}
+}
+
+void URiseProductionSubsystem::CompileRecipes()
+{
+	URiseBalanceDataSubsystem* BalanceData = UGameInstance::GetSubsystem<URiseBalanceDataSubsystem>(GetWorld()->GetGameInstance());
+	URiseResourceRegistrySubsystem* ResourceRegistry = URiseResourceRegistrySubsystem::Get(this);
+	if (!BalanceData || !ResourceRegistry || !EconomySubsystem)
+	{
+		return;
+	}
+
+	// Producers refer to recipes by index, so remember them by name and add them back once the new graph is compiled.
+	struct FSavedProducer
+	{
+		int32 ProducerId;
+		FName RecipeName;
+		uint8 PlayerIndex;
+		FRiseResourceAmount Efficiency;
+		int32 Progress;
+	};
+
+	TArray<FSavedProducer> SavedProducers;
+	for (int32 RecipeIndex = 0; RecipeIndex < RecipeProducers.Num(); ++RecipeIndex)
+	{
+		const FRiseRecipeProducers& Producers = RecipeProducers[RecipeIndex];
+		for (int32 Slot = 0; Slot < Producers.ProducerIds.Num(); ++Slot)
+		{
+			SavedProducers.Add({ Producers.ProducerIds[Slot], RecipeGraph.GetRecipe(RecipeIndex).Name, Producers.PlayerIndices[Slot], Producers.Efficiencies[Slot], Producers.Progress[Slot] });
+		}
+	}
+
+	RecipeGraph.Compile(BalanceData->GetRecipeDataTable(), ResourceRegistry, EconomySubsystem->GetEconomyTickInterval());
+
+	RecipeProducers.Reset();
+	RecipeProducers.SetNum(RecipeGraph.Num());
+	PlayerProduction.Reset();
+
+	for (const FSavedProducer& SavedProducer : SavedProducers)
+	{
+		int32 RecipeIndex = RecipeGraph.FindRecipeIndex(SavedProducer.RecipeName);
+		if (RecipeIndex == INDEX_NONE)
+		{
+			UE_LOG(LogRise, Warning, TEXT("Recipe %s no longer exists. Its producer has been stopped."), *SavedProducer.RecipeName.ToString());
+
+			ProducerLocations[SavedProducer.ProducerId] = FRiseProducerLocation();
+			continue;
+		}
+
+		// Progress beyond a shortened cycle is clamped on the next economy tick.
+		AddProducer(SavedProducer.ProducerId, RecipeIndex, SavedProducer.PlayerIndex, SavedProducer.Efficiency, SavedProducer.Progress);
+	}
+}
+
+void URiseProductionSubsystem::AddProducer(int32 ProducerId, int32 RecipeIndex, uint8 PlayerIndex, FRiseResourceAmount Efficiency, int32 Progress)
+{
+	FRiseRecipeProducers& Producers = RecipeProducers[RecipeIndex];
+	int32 Slot = Producers.ProducerIds.Add(ProducerId);
+	Producers.PlayerIndices.Add(PlayerIndex);
+	Producers.Efficiencies.Add(Efficiency);
+	Producers.Progress.Add(Progress);
+
+	ProducerLocations[ProducerId].RecipeIndex = RecipeIndex;
+	ProducerLocations[ProducerId].Slot = Slot;
+
+	++GetOrAddPlayerProduction(PlayerIndex).NumProducers[RecipeIndex];
+	AdjustRates(PlayerIndex, RecipeIndex, Efficiency, 1);
+}
+
+void URiseProductionSubsystem::RemoveProducer(int32 ProducerId)
+{
+	int32 RecipeIndex = ProducerLocations[ProducerId].RecipeIndex;
+	int32 Slot = ProducerLocations[ProducerId].Slot;
+	if (RecipeIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FRiseRecipeProducers& Producers = RecipeProducers[RecipeIndex];
+	uint8 PlayerIndex = Producers.PlayerIndices[Slot];
+
+	AdjustRates(PlayerIndex, RecipeIndex, Producers.Efficiencies[Slot], -1);
+
+	FRisePlayerProduction& Production = PlayerProduction[PlayerIndex];
+	if (--Production.NumProducers[RecipeIndex] == 0)
+	{
+		Production.StarvedInputs[RecipeIndex] = RISE_RESOURCE_ID_NONE;
+	}
+
+	// Swap the last producer into the freed slot to keep the arrays dense.
+	Producers.ProducerIds.RemoveAtSwap(Slot, 1, false);
+	Producers.PlayerIndices.RemoveAtSwap(Slot, 1, false);
+	Producers.Efficiencies.RemoveAtSwap(Slot, 1, false);
+	Producers.Progress.RemoveAtSwap(Slot, 1, false);
+
+	if (Producers.ProducerIds.IsValidIndex(Slot))
+	{
+		ProducerLocations[Producers.ProducerIds[Slot]].Slot = Slot;
+	}
+
+	ProducerLocations[ProducerId] = FRiseProducerLocation();
+}
+
+FRisePlayerProduction& URiseProductionSubsystem::GetOrAddPlayerProduction(uint8 PlayerIndex)
+{
+	if (!PlayerProduction.IsValidIndex(PlayerIndex))
+	{
+		PlayerProduction.SetNum(PlayerIndex + 1);
+	}
+
+	FRisePlayerProduction& Production = PlayerProduction[PlayerIndex];
+	if (Production.NumProducers.Num() != RecipeGraph.Num())
+	{
+		Production.SupplyRates.SetNumZeroed(RecipeGraph.GetNumResourceTypes());
+		Production.DemandRates.SetNumZeroed(RecipeGraph.GetNumResourceTypes());
+		Production.NumProducers.SetNumZeroed(RecipeGraph.Num());
+		Production.StarvedInputs.Init(RISE_RESOURCE_ID_NONE, RecipeGraph.Num());
+	}
+
+	return Production;
+}
+
+void URiseProductionSubsystem::AdjustRates(uint8 PlayerIndex, int32 RecipeIndex, FRiseResourceAmount Efficiency, int32 Sign)
+{
+	const FRiseCompiledRecipe& Recipe = RecipeGraph.GetRecipe(RecipeIndex);
+	FRisePlayerProduction& Production = GetOrAddPlayerProduction(PlayerIndex);
+
+	// Both directions use the same rounded contribution, so adding and removing a producer always cancels out.
+	for (const FRiseRecipeAmount& Output : Recipe.Outputs)
+	{
+		Production.SupplyRates[Output.ResourceId] += Sign * (static_cast<int64>(Output.Amount) * Efficiency / Recipe.CycleTicks);
+	}
+
+	for (const FRiseRecipeAmount& Input : Recipe.Inputs)
+	{
+		Production.DemandRates[Input.ResourceId] += Sign * (static_cast<int64>(Input.Amount) * Efficiency / Recipe.CycleTicks);
+	}
+}
+
+float URiseProductionSubsystem::RateToUnitsPerMinute(int64 Rate) const
+{
+	float EconomyTickInterval = EconomySubsystem ? EconomySubsystem->GetEconomyTickInterval() : 0.f;
+	if (EconomyTickInterval <= 0.f)
+	{
+		return 0.f;
+	}
+
+	return static_cast<float>(Rate) / (RISE_RESOURCE_AMOUNT_ONE * RISE_RESOURCE_AMOUNT_ONE) * (60.f / EconomyTickInterval);
+}
+
+void URiseProductionSubsystem::OnEconomyTick()
+{
+	// Recipes are stored in topological order, so each stage sees what the previous stages made this tick.
+	for (int32 RecipeIndex = 0; RecipeIndex < RecipeGraph.Num(); ++RecipeIndex)
+	{
+		FRiseRecipeProducers& Producers = RecipeProducers[RecipeIndex];
+		if (Producers.ProducerIds.IsEmpty())
+		{
+			continue;
+		}
+
+		const FRiseCompiledRecipe& Recipe = RecipeGraph.GetRecipe(RecipeIndex);
+		const int32 CycleProgress = Recipe.CycleTicks * RISE_RESOURCE_AMOUNT_ONE;
+
+		// Advance every producer and count the cycles due for each player.
+		DueCycles.Reset();
+		DueCycles.SetNumZeroed(PlayerProduction.Num());
+
+		for (int32 Slot = 0; Slot < Producers.ProducerIds.Num(); ++Slot)
+		{
+			int32& Progress = Producers.Progress[Slot];
+			Progress = FMath::Min(Progress + Producers.Efficiencies[Slot], CycleProgress);
+
+			if (Progress == CycleProgress)
+			{
+				++DueCycles[Producers.PlayerIndices[Slot]];
+			}
+		}
+
+		// Run as many of each player's due cycles as the stockpile can feed, with one transaction per ingredient.
+		bool bAnyCyclesRan = false;
+		for (int32 PlayerIndex = 0; PlayerIndex < DueCycles.Num(); ++PlayerIndex)
+		{
+			int32 NumCycles = DueCycles[PlayerIndex];
+			if (NumCycles == 0)
+			{
+				continue;
+			}
+
+			FRiseResourceId StarvedInput = RISE_RESOURCE_ID_NONE;
+			for (const FRiseRecipeAmount& Input : Recipe.Inputs)
+			{
+				int32 AffordableCycles = EconomySubsystem->GetResourceAmount(PlayerIndex, Input.ResourceId) / Input.Amount;
+				if (AffordableCycles < NumCycles)
+				{
+					NumCycles = AffordableCycles;
+					StarvedInput = Input.ResourceId;
+				}
+			}
+
+			if (NumCycles > 0)
+			{
+				// Only produce if every input was paid for. Refund the inputs already spent otherwise.
+				int32 NumInputsSpent = 0;
+				while (NumInputsSpent < Recipe.Inputs.Num())
+				{
+					const FRiseRecipeAmount& Input = Recipe.Inputs[NumInputsSpent];
+					if (!EconomySubsystem->TrySpend(PlayerIndex, Input.ResourceId, Input.Amount * NumCycles))
+					{
+						StarvedInput = Input.ResourceId;
+						break;
+					}
+
+					++NumInputsSpent;
+				}
+
+				if (NumInputsSpent == Recipe.Inputs.Num())
+				{
+					for (const FRiseRecipeAmount& Output : Recipe.Outputs)
+					{
+						EconomySubsystem->Deposit(PlayerIndex, Output.ResourceId, Output.Amount * NumCycles);
+					}
+
+					bAnyCyclesRan = true;
+				}
+				else
+				{
+					for (int32 InputIndex = 0; InputIndex < NumInputsSpent; ++InputIndex)
+					{
+						const FRiseRecipeAmount& Input = Recipe.Inputs[InputIndex];
+						EconomySubsystem->Deposit(PlayerIndex, Input.ResourceId, Input.Amount * NumCycles);
+					}
+
+					NumCycles = 0;
+				}
+			}
+
+			PlayerProduction[PlayerIndex].StarvedInputs[RecipeIndex] = StarvedInput;
+			DueCycles[PlayerIndex] = NumCycles;
+		}
+
+		if (!bAnyCyclesRan)
+		{
+			continue;
+		}
+
+		// Restart the producers whose cycles ran. Starved producers stay ready and try again next tick.
+		for (int32 Slot = 0; Slot < Producers.ProducerIds.Num(); ++Slot)
+		{
+			int32& RemainingCycles = DueCycles[Producers.PlayerIndices[Slot]];
+			if (RemainingCycles > 0 && Producers.Progress[Slot] == CycleProgress)
+			{
+				Producers.Progress[Slot] = 0;
+				--RemainingCycles;
+			}
+		}
+	}
+}
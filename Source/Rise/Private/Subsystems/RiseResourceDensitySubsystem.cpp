@@ -0,0 +1,182 @@
+#include "Subsystems/RiseResourceDensitySubsystem.h"
+
+#include "EngineUtils.h"
+
+#include "RiseLog.h"
+#include "Subsystems/RiseResourceNodeIndexSubsystem.h"
+#include "Volumes/RiseCameraBoundsVolume.h"
+
+URiseResourceDensitySubsystem::URiseResourceDensitySubsystem()
+{
+	DensityCellSize = 500.f;
+	DefaultHalfExtent = 50000.f;
+	Origin = FVector2D::ZeroVector;
+	Width = 0;
+	Height = 0;
+}
+
+bool URiseResourceDensitySubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseResourceDensitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = Cast<URiseResourceNodeIndexSubsystem>(Collection.InitializeDependency(URiseResourceNodeIndexSubsystem::StaticClass()));
+	if (NodeIndexSubsystem)
+	{
+		ResourceNodesChangedHandle = NodeIndexSubsystem->OnResourceNodesChanged.AddUObject(this, &URiseResourceDensitySubsystem::OnResourceNodesChanged);
+	}
+}
+
+void URiseResourceDensitySubsystem::Deinitialize()
+{
+	URiseResourceNodeIndexSubsystem* NodeIndexSubsystem = UWorld::GetSubsystem<URiseResourceNodeIndexSubsystem>(GetWorld());
+	if (NodeIndexSubsystem)
+	{
+		NodeIndexSubsystem->OnResourceNodesChanged.Remove(ResourceNodesChangedHandle);
+	}
+
+	ResourceNodesChangedHandle.Reset();
+	Grids.Empty();
+
+	Super::Deinitialize();
+}
+
+void URiseResourceDensitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (Width == 0)
+	{
+		InitializeBounds(InWorld);
+	}
+}
+
+float URiseResourceDensitySubsystem::EstimateResourceNodesInBox(FRiseResourceId ResourceId, const FBox2D& Box) const
+{
+	if (!Grids.IsValidIndex(ResourceId) || Grids[ResourceId].Tree.IsEmpty())
+	{
+		return 0.f;
+	}
+
+	const FRiseResourceDensityGrid& Grid = Grids[ResourceId];
+
+	float MinX = (Box.Min.X - Origin.X) / DensityCellSize;
+	float MinY = (Box.Min.Y - Origin.Y) / DensityCellSize;
+	float MaxX = (Box.Max.X - Origin.X) / DensityCellSize;
+	float MaxY = (Box.Max.Y - Origin.Y) / DensityCellSize;
+
+	return SampleSummedCounts(Grid, MaxX, MaxY)
+		- SampleSummedCounts(Grid, MinX, MaxY)
+		- SampleSummedCounts(Grid, MaxX, MinY)
+		+ SampleSummedCounts(Grid, MinX, MinY);
+}
+
+float URiseResourceDensitySubsystem::EstimateResourceNodesInRadius(FRiseResourceId ResourceId, const FVector& Location, float Radius) const
+{
+	if (Radius <= 0.f)
+	{
+		return 0.f;
+	}
+
+	// A square with sides of sqrt(pi) * r has the same area as the circle.
+	float HalfSize = 0.5f * FMath::Sqrt(PI) * Radius;
+	FVector2D Center(Location.X, Location.Y);
+
+	return EstimateResourceNodesInBox(ResourceId, FBox2D(Center - HalfSize, Center + HalfSize));
+}
+
+float URiseResourceDensitySubsystem::GetDensityCellSize() const
+{
+	return DensityCellSize;
+}
+
+void URiseResourceDensitySubsystem::InitializeBounds(UWorld& InWorld)
+{
+	FBox2D Bounds(FVector2D(-DefaultHalfExtent), FVector2D(DefaultHalfExtent));
+
+	// Resources outside the camera bounds are never interesting, so only cover the area inside them.
+	TActorIterator<ARiseCameraBoundsVolume> ActorItr(&InWorld);
+	if (ActorItr)
+	{
+		FBox VolumeBounds = ActorItr->GetBounds().GetBox();
+		Bounds = FBox2D(FVector2D(VolumeBounds.Min.X, VolumeBounds.Min.Y), FVector2D(VolumeBounds.Max.X, VolumeBounds.Max.Y));
+	}
+
+	Origin = Bounds.Min;
+	Width = FMath::Max(1, FMath::CeilToInt(Bounds.GetSize().X / DensityCellSize));
+	Height = FMath::Max(1, FMath::CeilToInt(Bounds.GetSize().Y / DensityCellSize));
+
+	UE_LOG(LogRise, Log, TEXT("Resource density grids cover %ix%i cells of %.0f units."), Width, Height, DensityCellSize);
+}
+
+void URiseResourceDensitySubsystem::OnResourceNodesChanged(FRiseResourceId ResourceId, const FVector& Location, int32 Delta)
+{
+	if (Width == 0)
+	{
+		InitializeBounds(*GetWorld());
+	}
+
+	if (!Grids.IsValidIndex(ResourceId))
+	{
+		Grids.SetNum(ResourceId + 1);
+	}
+
+	FRiseResourceDensityGrid& Grid = Grids[ResourceId];
+	if (Grid.Tree.IsEmpty())
+	{
+		Grid.Tree.SetNumZeroed((Width + 1) * (Height + 1));
+	}
+
+	// Nodes outside the covered area count towards the nearest edge cell.
+	int32 CellX = FMath::Clamp(FMath::FloorToInt((Location.X - Origin.X) / DensityCellSize), 0, Width - 1);
+	int32 CellY = FMath::Clamp(FMath::FloorToInt((Location.Y - Origin.Y) / DensityCellSize), 0, Height - 1);
+
+	const int32 Stride = Width + 1;
+
+	for (int32 Y = CellY + 1; Y <= Height; Y += Y & -Y)
+	{
+		for (int32 X = CellX + 1; X <= Width; X += X & -X)
+		{
+			Grid.Tree[Y * Stride + X] += Delta;
+		}
+	}
+}
+
+int32 URiseResourceDensitySubsystem::GetSummedCount(const FRiseResourceDensityGrid& Grid, int32 X, int32 Y) const
+{
+	const int32 Stride = Width + 1;
+
+	int32 Count = 0;
+	for (int32 TreeY = Y; TreeY > 0; TreeY -= TreeY & -TreeY)
+	{
+		for (int32 TreeX = X; TreeX > 0; TreeX -= TreeX & -TreeX)
+		{
+			Count += Grid.Tree[TreeY * Stride + TreeX];
+		}
+	}
+
+	return Count;
+}
+
+float URiseResourceDensitySubsystem::SampleSummedCounts(const FRiseResourceDensityGrid& Grid, float CellX, float CellY) const
+{
+	CellX = FMath::Clamp(CellX, 0.f, static_cast<float>(Width));
+	CellY = FMath::Clamp(CellY, 0.f, static_cast<float>(Height));
+
+	int32 X0 = FMath::Min(FMath::FloorToInt(CellX), Width - 1);
+	int32 Y0 = FMath::Min(FMath::FloorToInt(CellY), Height - 1);
+	float AlphaX = CellX - X0;
+	float AlphaY = CellY - Y0;
+
+	float S00 = GetSummedCount(Grid, X0, Y0);
+	float S10 = GetSummedCount(Grid, X0 + 1, Y0);
+	float S01 = GetSummedCount(Grid, X0, Y0 + 1);
+	float S11 = GetSummedCount(Grid, X0 + 1, Y0 + 1);
+
+	// With the nodes spread evenly through each cell, the summed count is bilinear within a cell.
+	return FMath::BiLerp(S00, S10, S01, S11, AlphaX, AlphaY);
+}
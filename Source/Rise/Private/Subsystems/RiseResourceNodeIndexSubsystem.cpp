@@ -0,0 +1,391 @@
+#include "Subsystems/RiseResourceNodeIndexSubsystem.h"
+
+#include "GameFramework/Actor.h"
+
+#include "RiseResourceField.h"
+#include "Components/RiseResourceComponent.h"
+
+URiseResourceNodeIndexSubsystem::URiseResourceNodeIndexSubsystem()
+{
+	CellSize = 2000.f;
+}
+
+bool URiseResourceNodeIndexSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseResourceNodeIndexSubsystem::Deinitialize()
+{
+	for (FRiseResourceNodeGrid& Grid : Grids)
+	{
+		for (TPair<FIntPoint, FRiseResourceNodeCell>& Cell : Grid.Cells)
+		{
+			for (int32 Slot = 0; Slot < Cell.Value.Nodes.Num(); ++Slot)
+			{
+				if (URiseResourceComponent* ResourceComponent = Cell.Value.Nodes[Slot])
+				{
+					ResourceComponent->NodeIndexSlot = INDEX_NONE;
+				}
+				else if (ARiseResourceField* ResourceField = Cell.Value.Fields[Slot])
+				{
+					ResourceField->InstanceNodeIndexSlots[Cell.Value.FieldInstances[Slot]] = INDEX_NONE;
+				}
+			}
+		}
+	}
+
+	Grids.Empty();
+	OnResourceNodesChanged.Clear();
+
+	Super::Deinitialize();
+}
+
+void URiseResourceNodeIndexSubsystem::RegisterResourceNode(URiseResourceComponent* ResourceComponent)
+{
+	if (!ResourceComponent || !ResourceComponent->GetOwner() || ResourceComponent->NodeIndexSlot != INDEX_NONE)
+	{
+		return;
+	}
+
+	FRiseResourceId ResourceId = ResourceComponent->GetResourceId();
+	if (ResourceId == RISE_RESOURCE_ID_NONE)
+	{
+		return;
+	}
+
+	FVector Location = ResourceComponent->GetOwner()->GetActorLocation();
+	FIntPoint CellCoordinates = GetCell(Location);
+
+	ResourceComponent->NodeIndexCell = CellCoordinates;
+	ResourceComponent->NodeIndexSlot = AddEntry(ResourceId, Location, CellCoordinates, ResourceComponent, nullptr, INDEX_NONE);
+}
+
+void URiseResourceNodeIndexSubsystem::UnregisterResourceNode(URiseResourceComponent* ResourceComponent)
+{
+	if (!ResourceComponent || ResourceComponent->NodeIndexSlot == INDEX_NONE)
+	{
+		return;
+	}
+
+	int32 Slot = ResourceComponent->NodeIndexSlot;
+	check(Grids[ResourceComponent->GetResourceId()].Cells.FindChecked(ResourceComponent->NodeIndexCell).Nodes[Slot] == ResourceComponent);
+
+	ResourceComponent->NodeIndexSlot = INDEX_NONE;
+	RemoveEntry(ResourceComponent->GetResourceId(), ResourceComponent->NodeIndexCell, Slot);
+}
+
+void URiseResourceNodeIndexSubsystem::RegisterFieldInstance(ARiseResourceField* ResourceField, int32 InstanceIndex, FRiseResourceId ResourceId, const FVector& Location)
+{
+	if (!ResourceField || !ResourceField->InstanceNodeIndexSlots.IsValidIndex(InstanceIndex) || ResourceField->InstanceNodeIndexSlots[InstanceIndex] != INDEX_NONE)
+	{
+		return;
+	}
+
+	if (ResourceId == RISE_RESOURCE_ID_NONE)
+	{
+		return;
+	}
+
+	FIntPoint CellCoordinates = GetCell(Location);
+
+	ResourceField->InstanceNodeIndexCells[InstanceIndex] = CellCoordinates;
+	ResourceField->InstanceNodeIndexSlots[InstanceIndex] = AddEntry(ResourceId, Location, CellCoordinates, nullptr, ResourceField, InstanceIndex);
+}
+
+void URiseResourceNodeIndexSubsystem::UnregisterFieldInstance(ARiseResourceField* ResourceField, int32 InstanceIndex)
+{
+	if (!ResourceField || !ResourceField->InstanceNodeIndexSlots.IsValidIndex(InstanceIndex))
+	{
+		return;
+	}
+
+	int32 Slot = ResourceField->InstanceNodeIndexSlots[InstanceIndex];
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	ResourceField->InstanceNodeIndexSlots[InstanceIndex] = INDEX_NONE;
+	RemoveEntry(ResourceField->ResourceId, ResourceField->InstanceNodeIndexCells[InstanceIndex], Slot);
+}
+
+void URiseResourceNodeIndexSubsystem::FindNearestResourceNodes(FRiseResourceId ResourceId, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<URiseResourceComponent*>& OutResourceNodes)
+{
+	OutResourceNodes.Reset();
+
+	if (!Grids.IsValidIndex(ResourceId) || Grids[ResourceId].NumNodes == 0)
+	{
+		return;
+	}
+
+	const FRiseResourceNodeGrid* Grid = &Grids[ResourceId];
+
+	TArray<FNearestCandidate, TInlineAllocator<16>> Candidates;
+	FindNearestInGrids(MakeArrayView(&Grid, 1), Location, MaxResults, MaxDistance, Candidates);
+	ResolveCandidates(Candidates, OutResourceNodes);
+}
+
+void URiseResourceNodeIndexSubsystem::FindNearestResourceNodes(const FRiseResourceFilter& Filter, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<URiseResourceComponent*>& OutResourceNodes)
+{
+	OutResourceNodes.Reset();
+
+	TArray<const FRiseResourceNodeGrid*, TInlineAllocator<8>> SearchGrids;
+	Filter.ForEach([this, &SearchGrids](FRiseResourceId ResourceId)
+	{
+		if (Grids.IsValidIndex(ResourceId) && Grids[ResourceId].NumNodes > 0)
+		{
+			SearchGrids.Add(&Grids[ResourceId]);
+		}
+	});
+
+	if (SearchGrids.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FNearestCandidate, TInlineAllocator<16>> Candidates;
+	FindNearestInGrids(SearchGrids, Location, MaxResults, MaxDistance, Candidates);
+	ResolveCandidates(Candidates, OutResourceNodes);
+}
+
+URiseResourceComponent* URiseResourceNodeIndexSubsystem::FindNearestResourceNode(FRiseResourceId ResourceId, const FVector& Location, float MaxDistance)
+{
+	TArray<URiseResourceComponent*> ResourceNodes;
+	FindNearestResourceNodes(ResourceId, Location, 1, MaxDistance, ResourceNodes);
+
+	return ResourceNodes.IsEmpty() ? nullptr : ResourceNodes[0];
+}
+
+int32 URiseResourceNodeIndexSubsystem::CountResourceNodesInRadius(FRiseResourceId ResourceId, const FVector& Location, float Radius) const
+{
+	if (!Grids.IsValidIndex(ResourceId) || Grids[ResourceId].NumNodes == 0 || Radius <= 0.f)
+	{
+		return 0;
+	}
+
+	const FRiseResourceNodeGrid& Grid = Grids[ResourceId];
+	float RadiusSquared = FMath::Square(Radius);
+
+	FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.f));
+	FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.f));
+
+	// Never walk cells the grid has never used.
+	MinCell = FIntPoint(FMath::Max(MinCell.X, Grid.MinCell.X), FMath::Max(MinCell.Y, Grid.MinCell.Y));
+	MaxCell = FIntPoint(FMath::Min(MaxCell.X, Grid.MaxCell.X), FMath::Min(MaxCell.Y, Grid.MaxCell.Y));
+
+	int32 Count = 0;
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const FRiseResourceNodeCell* Cell = Grid.Cells.Find(FIntPoint(X, Y));
+			if (!Cell)
+			{
+				continue;
+			}
+
+			for (const FVector& NodeLocation : Cell->Locations)
+			{
+				if (FVector::DistSquared2D(Location, NodeLocation) <= RadiusSquared)
+				{
+					++Count;
+				}
+			}
+		}
+	}
+
+	return Count;
+}
+
+int32 URiseResourceNodeIndexSubsystem::GetNumResourceNodes(FRiseResourceId ResourceId) const
+{
+	return Grids.IsValidIndex(ResourceId) ? Grids[ResourceId].NumNodes : 0;
+}
+
+FIntPoint URiseResourceNodeIndexSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+int32 URiseResourceNodeIndexSubsystem::AddEntry(FRiseResourceId ResourceId, const FVector& Location, const FIntPoint& CellCoordinates, URiseResourceComponent* ResourceComponent, ARiseResourceField* ResourceField, int32 FieldInstance)
+{
+	if (!Grids.IsValidIndex(ResourceId))
+	{
+		Grids.SetNum(ResourceId + 1);
+	}
+
+	FRiseResourceNodeGrid& Grid = Grids[ResourceId];
+	FRiseResourceNodeCell& Cell = Grid.Cells.FindOrAdd(CellCoordinates);
+
+	int32 Slot = Cell.Nodes.Add(ResourceComponent);
+	Cell.Fields.Add(ResourceField);
+	Cell.FieldInstances.Add(FieldInstance);
+	Cell.Locations.Add(Location);
+
+	Grid.MinCell = FIntPoint(FMath::Min(Grid.MinCell.X, CellCoordinates.X), FMath::Min(Grid.MinCell.Y, CellCoordinates.Y));
+	Grid.MaxCell = FIntPoint(FMath::Max(Grid.MaxCell.X, CellCoordinates.X), FMath::Max(Grid.MaxCell.Y, CellCoordinates.Y));
+	++Grid.NumNodes;
+
+	OnResourceNodesChanged.Broadcast(ResourceId, Location, 1);
+
+	return Slot;
+}
+
+void URiseResourceNodeIndexSubsystem::RemoveEntry(FRiseResourceId ResourceId, const FIntPoint& CellCoordinates, int32 Slot)
+{
+	FRiseResourceNodeGrid& Grid = Grids[ResourceId];
+	FRiseResourceNodeCell& Cell = Grid.Cells.FindChecked(CellCoordinates);
+	check(Cell.Nodes.IsValidIndex(Slot));
+
+	FVector Location = Cell.Locations[Slot];
+
+	// Swap the last entry into the freed slot to keep the cell dense.
+	Cell.Nodes.RemoveAtSwap(Slot, 1, false);
+	Cell.Fields.RemoveAtSwap(Slot, 1, false);
+	Cell.FieldInstances.RemoveAtSwap(Slot, 1, false);
+	Cell.Locations.RemoveAtSwap(Slot, 1, false);
+
+	if (Cell.Nodes.IsValidIndex(Slot))
+	{
+		if (URiseResourceComponent* MovedComponent = Cell.Nodes[Slot])
+		{
+			MovedComponent->NodeIndexSlot = Slot;
+		}
+		else
+		{
+			Cell.Fields[Slot]->InstanceNodeIndexSlots[Cell.FieldInstances[Slot]] = Slot;
+		}
+	}
+
+	if (Cell.Nodes.IsEmpty())
+	{
+		Grid.Cells.Remove(CellCoordinates);
+	}
+
+	--Grid.NumNodes;
+
+	OnResourceNodesChanged.Broadcast(ResourceId, Location, -1);
+}
+
+void URiseResourceNodeIndexSubsystem::ResolveCandidates(TArrayView<const FNearestCandidate> Candidates, TArray<URiseResourceComponent*>& OutResourceNodes)
+{
+	OutResourceNodes.Reserve(Candidates.Num());
+
+	// The search is complete, so promoting field nodes can no longer disturb the cells being walked.
+	for (const FNearestCandidate& Candidate : Candidates)
+	{
+		URiseResourceComponent* ResourceComponent = Candidate.Node ? Candidate.Node : Candidate.Field->PromoteInstance(Candidate.FieldInstance);
+		if (ResourceComponent)
+		{
+			OutResourceNodes.Add(ResourceComponent);
+		}
+	}
+}
+
+void URiseResourceNodeIndexSubsystem::FindNearestInGrids(TArrayView<const FRiseResourceNodeGrid* const> SearchGrids, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<FNearestCandidate, TInlineAllocator<16>>& Candidates) const
+{
+	if (MaxResults <= 0)
+	{
+		return;
+	}
+
+	FIntPoint CenterCell = GetCell(Location);
+	float MaxDistanceSquared = MaxDistance > 0.f ? FMath::Square(MaxDistance) : MAX_flt;
+
+	// Search no further than the farthest cell any of the grids has used.
+	FIntPoint MinCell(MAX_int32, MAX_int32);
+	FIntPoint MaxCell(MIN_int32, MIN_int32);
+	for (const FRiseResourceNodeGrid* Grid : SearchGrids)
+	{
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Grid->MinCell.X), FMath::Min(MinCell.Y, Grid->MinCell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Grid->MaxCell.X), FMath::Max(MaxCell.Y, Grid->MaxCell.Y));
+	}
+
+	int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(CenterCell.X - MinCell.X), FMath::Abs(MaxCell.X - CenterCell.X)),
+		FMath::Max(FMath::Abs(CenterCell.Y - MinCell.Y), FMath::Abs(MaxCell.Y - CenterCell.Y)));
+
+	if (MaxDistance > 0.f)
+	{
+		MaxRing = FMath::Min(MaxRing, FMath::CeilToInt(MaxDistance / CellSize));
+	}
+
+	auto VisitCell = [&](int32 X, int32 Y)
+	{
+		if (X < MinCell.X || X > MaxCell.X || Y < MinCell.Y || Y > MaxCell.Y)
+		{
+			return;
+		}
+
+		for (const FRiseResourceNodeGrid* Grid : SearchGrids)
+		{
+			if (const FRiseResourceNodeCell* Cell = Grid->Cells.Find(FIntPoint(X, Y)))
+			{
+				GatherCandidates(*Cell, Location, MaxResults, MaxDistanceSquared, Candidates);
+			}
+		}
+	};
+
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring == 0)
+		{
+			VisitCell(CenterCell.X, CenterCell.Y);
+		}
+		else
+		{
+			// Walk the perimeter of the square of cells Ring steps away from the center.
+			for (int32 X = CenterCell.X - Ring; X <= CenterCell.X + Ring; ++X)
+			{
+				VisitCell(X, CenterCell.Y - Ring);
+				VisitCell(X, CenterCell.Y + Ring);
+			}
+
+			for (int32 Y = CenterCell.Y - Ring + 1; Y <= CenterCell.Y + Ring - 1; ++Y)
+			{
+				VisitCell(CenterCell.X - Ring, Y);
+				VisitCell(CenterCell.X + Ring, Y);
+			}
+		}
+
+		// Every node beyond this ring is at least Ring cells away, so stop once all the
+		// candidates are closer than that.
+		if (Candidates.Num() == MaxResults && Candidates.Last().DistanceSquared <= FMath::Square(Ring * CellSize))
+		{
+			break;
+		}
+	}
+}
+
+void URiseResourceNodeIndexSubsystem::GatherCandidates(const FRiseResourceNodeCell& Cell, const FVector& Location, int32 MaxResults, float MaxDistanceSquared, TArray<FNearestCandidate, TInlineAllocator<16>>& Candidates)
+{
+	for (int32 Slot = 0; Slot < Cell.Locations.Num(); ++Slot)
+	{
+		float DistanceSquared = FVector::DistSquared2D(Location, Cell.Locations[Slot]);
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		if (Candidates.Num() == MaxResults && DistanceSquared >= Candidates.Last().DistanceSquared)
+		{
+			continue;
+		}
+
+		// The candidate list is short, so a sorted insert is cheaper than a heap.
+		int32 InsertIndex = Candidates.Num();
+		while (InsertIndex > 0 && Candidates[InsertIndex - 1].DistanceSquared > DistanceSquared)
+		{
+			--InsertIndex;
+		}
+
+		Candidates.Insert({ DistanceSquared, Cell.Nodes[Slot], Cell.Fields[Slot], Cell.FieldInstances[Slot] }, InsertIndex);
+
+		if (Candidates.Num() > MaxResults)
+		{
+			Candidates.Pop(false);
+		}
+	}
+}
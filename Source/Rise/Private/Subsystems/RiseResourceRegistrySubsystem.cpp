@@ -0,0 +1,152 @@
+#include "Subsystems/RiseResourceRegistrySubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+
+#include "RiseLog.h"
+#include "RiseResource.h"
+#include "Subsystems/RiseClassRegistrySubsystem.h"
+
+void URiseResourceRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	BuildResourceTypes();
+}
+
+void URiseResourceRegistrySubsystem::Deinitialize()
+{
+	ResourceTypes.Empty();
+	ResourceIds.Empty();
+	ResourceTags.Empty();
+	TagFilters.Empty();
+
+	Super::Deinitialize();
+}
+
+URiseResourceRegistrySubsystem* URiseResourceRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? UGameInstance::GetSubsystem<URiseResourceRegistrySubsystem>(World->GetGameInstance()) : nullptr;
+}
+
+int32 URiseResourceRegistrySubsystem::GetNumResourceTypes() const
+{
+	return ResourceTypes.Num();
+}
+
+FRiseResourceId URiseResourceRegistrySubsystem::GetResourceId(TSubclassOf<URiseResource> ResourceType) const
+{
+	const FRiseResourceId* ResourceId = ResourceIds.Find(ResourceType);
+	return ResourceId ? *ResourceId : RISE_RESOURCE_ID_NONE;
+}
+
+TSubclassOf<URiseResource> URiseResourceRegistrySubsystem::GetResourceType(FRiseResourceId ResourceId) const
+{
+	return ResourceTypes.IsValidIndex(ResourceId) ? ResourceTypes[ResourceId] : nullptr;
+}
+
+const FGameplayTagContainer& URiseResourceRegistrySubsystem::GetResourceTags(FRiseResourceId ResourceId) const
+{
+	return ResourceTags.IsValidIndex(ResourceId) ? ResourceTags[ResourceId] : FGameplayTagContainer::EmptyContainer;
+}
+
+FRiseResourceFilter URiseResourceRegistrySubsystem::MakeFilter(const FGameplayTagContainer& Tags, bool bMatchAll) const
+{
+	FRiseResourceFilter Filter;
+
+	for (int32 ResourceId = 0; ResourceId < ResourceTags.Num(); ++ResourceId)
+	{
+		bool bMatches = bMatchAll ? ResourceTags[ResourceId].HasAll(Tags) : ResourceTags[ResourceId].HasAny(Tags);
+		if (bMatches)
+		{
+			Filter.Add(ResourceId);
+		}
+	}
+
+	return Filter;
+}
+
+FRiseResourceFilter URiseResourceRegistrySubsystem::GetFilterForTag(FGameplayTag Tag)
+{
+	if (const FRiseResourceFilter* CachedFilter = TagFilters.Find(Tag))
+	{
+		return *CachedFilter;
+	}
+
+	return TagFilters.Add(Tag, MakeFilter(FGameplayTagContainer(Tag)));
+}
+
+uint32 URiseResourceRegistrySubsystem::GetChecksum() const
+{
+	return Checksum;
+}
+
+void URiseResourceRegistrySubsystem::BuildResourceTypes()
+{
+	TArray<FSoftClassPath> ResourceTypePaths;
+
+	// Native resource types.
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		if (Class != URiseResource::StaticClass()
+			&& Class->IsChildOf(URiseResource::StaticClass())
+			&& Class->HasAnyClassFlags(CLASS_Native)
+			&& !Class->HasAnyClassFlags(CLASS_Abstract))
+		{
+			ResourceTypePaths.Add(FSoftClassPath(Class));
+		}
+	}
+
+	// Blueprint resource types.
+	URiseClassRegistrySubsystem* ClassRegistry = URiseClassRegistrySubsystem::Get();
+	if (ClassRegistry)
+	{
+		TArray<FSoftObjectPath> ClassPaths;
+		ClassRegistry->FindBlueprintClasses(URiseResource::StaticClass(), nullptr, nullptr, ClassPaths);
+
+		for (const FSoftObjectPath& ClassPath : ClassPaths)
+		{
+			ResourceTypePaths.Add(FSoftClassPath(ClassPath.ToString()));
+		}
+	}
+
+	// Sort by path so every machine with the same content assigns the same ids.
+	ResourceTypePaths.Sort([](const FSoftClassPath& A, const FSoftClassPath& B)
+	{
+		return A.ToString() < B.ToString();
+	});
+
+	check(ResourceTypePaths.Num() < RISE_RESOURCE_ID_NONE);
+
+	ResourceTypes.Reset(ResourceTypePaths.Num());
+	ResourceIds.Reset();
+	ResourceTags.Reset(ResourceTypePaths.Num());
+	TagFilters.Reset();
+	Checksum = 0;
+
+	for (const FSoftClassPath& ResourceTypePath : ResourceTypePaths)
+	{
+		// Resource types are tiny, so load them all now to read their tags.
+		TSubclassOf<URiseResource> ResourceType = ResourceTypePath.TryLoadClass<URiseResource>();
+		if (!ResourceType)
+		{
+			// Keep the slot so the ids of the following types do not shift.
+			UE_LOG(LogRise, Warning, TEXT("Unable to load resource type %s."), *ResourceTypePath.ToString());
+		}
+
+		FRiseResourceId ResourceId = ResourceTypes.Add(ResourceType);
+		ResourceTags.Add(ResourceType ? ResourceType.GetDefaultObject()->GetResourceTags() : FGameplayTagContainer());
+
+		if (ResourceType)
+		{
+			ResourceIds.Add(ResourceType, ResourceId);
+		}
+
+		Checksum = FCrc::StrCrc32(*ResourceTypePath.ToString(), Checksum);
+	}
+
+	UE_LOG(LogRise, Log, TEXT("Registered %i resource types (checksum %08x)."), ResourceTypes.Num(), Checksum);
+}
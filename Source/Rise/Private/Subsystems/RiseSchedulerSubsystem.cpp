@@ -0,0 +1,263 @@
+#include "Subsystems/RiseSchedulerSubsystem.h"
+
+#include "RiseStats.h"
+
+URiseSchedulerSubsystem::URiseSchedulerSubsystem()
+{
+	SchedulerTickInterval = 0.5f;
+	SchedulerTickAccumulator = 0.f;
+	CurrentTick = 0;
+	FirstFreeEvent = INDEX_NONE;
+	NumScheduledEvents = 0;
+
+	for (int32& SlotHead : SlotHeads)
+	{
+		SlotHead = INDEX_NONE;
+	}
+}
+
+bool URiseSchedulerSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URiseSchedulerSubsystem::Deinitialize()
+{
+	Events.Empty();
+	FiringDelegates.Empty();
+	FirstFreeEvent = INDEX_NONE;
+	NumScheduledEvents = 0;
+
+	for (int32& SlotHead : SlotHeads)
+	{
+		SlotHead = INDEX_NONE;
+	}
+
+	Super::Deinitialize();
+}
+
+void URiseSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (SchedulerTickInterval <= 0.f)
+	{
+		SchedulerTick();
+		return;
+	}
+
+	SchedulerTickAccumulator += DeltaTime;
+
+	// Ticks with nothing to fire are cheap, so always catch up fully.
+	while (SchedulerTickAccumulator >= SchedulerTickInterval)
+	{
+		SchedulerTickAccumulator -= SchedulerTickInterval;
+
+		SchedulerTick();
+	}
+}
+
+TStatId URiseSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URiseSchedulerSubsystem, STATGROUP_Rise);
+}
+
+FRiseScheduledEventHandle URiseSchedulerSubsystem::ScheduleEvent(float Delay, FSimpleDelegate Delegate)
+{
+	FRiseScheduledEventHandle Handle;
+
+	if (!Delegate.IsBound())
+	{
+		return Handle;
+	}
+
+	// Count the time already accumulated towards the next tick so events never fire early.
+	int32 DelayTicks = 1;
+	if (SchedulerTickInterval > 0.f)
+	{
+		DelayTicks = FMath::Max(1, FMath::CeilToInt((FMath::Max(Delay, 0.f) + SchedulerTickAccumulator) / SchedulerTickInterval));
+	}
+
+	int32 EventIndex = FirstFreeEvent;
+	if (EventIndex != INDEX_NONE)
+	{
+		FirstFreeEvent = Events[EventIndex].Next;
+	}
+	else
+	{
+		EventIndex = Events.AddDefaulted();
+	}
+
+	FScheduledEvent& Event = Events[EventIndex];
+	Event.Delegate = MoveTemp(Delegate);
+	Event.FireTick = CurrentTick + DelayTicks;
+
+	LinkEvent(EventIndex);
+	++NumScheduledEvents;
+
+	Handle.Index = EventIndex;
+	Handle.Serial = Event.Serial;
+
+	return Handle;
+}
+
+bool URiseSchedulerSubsystem::CancelEvent(FRiseScheduledEventHandle& Handle)
+{
+	bool bScheduled = IsEventScheduled(Handle);
+	if (bScheduled)
+	{
+		UnlinkEvent(Handle.Index);
+		FreeEvent(Handle.Index);
+	}
+
+	Handle.Invalidate();
+
+	return bScheduled;
+}
+
+bool URiseSchedulerSubsystem::IsEventScheduled(const FRiseScheduledEventHandle& Handle) const
+{
+	return Events.IsValidIndex(Handle.Index)
+		&& Events[Handle.Index].Serial == Handle.Serial
+		&& Events[Handle.Index].Slot != INDEX_NONE;
+}
+
+float URiseSchedulerSubsystem::GetTimeRemaining(const FRiseScheduledEventHandle& Handle) const
+{
+	if (!IsEventScheduled(Handle))
+	{
+		return -1.f;
+	}
+
+	uint64 RemainingTicks = Events[Handle.Index].FireTick - CurrentTick;
+	return FMath::Max(0.f, RemainingTicks * SchedulerTickInterval - SchedulerTickAccumulator);
+}
+
+int32 URiseSchedulerSubsystem::GetNumScheduledEvents() const
+{
+	return NumScheduledEvents;
+}
+
+void URiseSchedulerSubsystem::SchedulerTick()
+{
+	++CurrentTick;
+
+	// Each time a level wraps around, the next slot of the level above moves down.
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		const int32 LevelShift = SlotBits * Level;
+		if ((CurrentTick & ((1ull << LevelShift) - 1)) != 0)
+		{
+			break;
+		}
+
+		CascadeSlot(Level, static_cast<int32>((CurrentTick >> LevelShift) & (SlotsPerLevel - 1)));
+	}
+
+	if (NumScheduledEvents == 0)
+	{
+		return;
+	}
+
+	// Take every due event out of the wheel before firing any, so the delegates can freely
+	// schedule and cancel events.
+	int32 EventIndex = SlotHeads[CurrentTick & (SlotsPerLevel - 1)];
+
+	while (EventIndex != INDEX_NONE)
+	{
+		FScheduledEvent& Event = Events[EventIndex];
+		int32 NextEventIndex = Event.Next;
+
+		if (Event.FireTick <= CurrentTick)
+		{
+			FiringDelegates.Add(MoveTemp(Event.Delegate));
+
+			UnlinkEvent(EventIndex);
+			FreeEvent(EventIndex);
+		}
+
+		EventIndex = NextEventIndex;
+	}
+
+	for (FSimpleDelegate& Delegate : FiringDelegates)
+	{
+		Delegate.ExecuteIfBound();
+	}
+
+	FiringDelegates.Reset();
+}
+
+void URiseSchedulerSubsystem::LinkEvent(int32 EventIndex)
+{
+	FScheduledEvent& Event = Events[EventIndex];
+	uint64 DeltaTicks = Event.FireTick - FMath::Min(Event.FireTick, CurrentTick);
+
+	// Events further away than the wheel can represent wait in the top level and cascade back into it.
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && DeltaTicks >= (1ull << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	int32 Slot = Level * SlotsPerLevel + static_cast<int32>((Event.FireTick >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+
+	Event.Slot = Slot;
+	Event.Prev = INDEX_NONE;
+	Event.Next = SlotHeads[Slot];
+
+	if (Event.Next != INDEX_NONE)
+	{
+		Events[Event.Next].Prev = EventIndex;
+	}
+
+	SlotHeads[Slot] = EventIndex;
+}
+
+void URiseSchedulerSubsystem::UnlinkEvent(int32 EventIndex)
+{
+	FScheduledEvent& Event = Events[EventIndex];
+
+	if (Event.Prev != INDEX_NONE)
+	{
+		Events[Event.Prev].Next = Event.Next;
+	}
+	else
+	{
+		SlotHeads[Event.Slot] = Event.Next;
+	}
+
+	if (Event.Next != INDEX_NONE)
+	{
+		Events[Event.Next].Prev = Event.Prev;
+	}
+
+	Event.Slot = INDEX_NONE;
+	Event.Prev = INDEX_NONE;
+	Event.Next = INDEX_NONE;
+}
+
+void URiseSchedulerSubsystem::FreeEvent(int32 EventIndex)
+{
+	FScheduledEvent& Event = Events[EventIndex];
+
+	Event.Delegate.Unbind();
+	++Event.Serial;
+	Event.Next = FirstFreeEvent;
+
+	FirstFreeEvent = EventIndex;
+	--NumScheduledEvents;
+}
+
+void URiseSchedulerSubsystem::CascadeSlot(int32 Level, int32 Slot)
+{
+	int32& SlotHead = SlotHeads[Level * SlotsPerLevel + Slot];
+	int32 EventIndex = SlotHead;
+	SlotHead = INDEX_NONE;
+
+	while (EventIndex != INDEX_NONE)
+	{
+		int32 NextEventIndex = Events[EventIndex].Next;
+		LinkEvent(EventIndex);
+		EventIndex = NextEventIndex;
+	}
+}
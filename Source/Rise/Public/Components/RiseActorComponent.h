@@ -23,6 +23,17 @@ public:
 	 * @param TagContainer The container to add the tags to.
 	 */
 	virtual void AddGameplayTags(FGameplayTagContainer& TagContainer) override;
+
+	/**
+	 * Called when the owning actor is returned to the actor pool. Components should reset any
+	 * per-instance state here so the actor can be reused as if it was freshly spawned.
+	 */
+	virtual void OnReleasedToPool();
+
+	/**
+	 * Called when the owning actor is taken from the actor pool to be reused.
+	 */
+	virtual void OnAcquiredFromPool();
 		
 protected:
 
@@ -1,18 +1,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/ActorComponent.h"
 
+#include "Components/RiseActorComponent.h"
 #include "RiseOwnableComponent.generated.h"
 
 class AController;
 class ARisePlayerState;
+class URiseOwnershipSubsystem;
 
 /**
  * When attached to an actor, allows a player to own that actor.
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class RISE_API URiseOwnableComponent : public UActorComponent
+class RISE_API URiseOwnableComponent : public URiseActorComponent
 {
 	GENERATED_BODY()
 
@@ -22,14 +23,32 @@ private:
 	UPROPERTY(EditInstanceOnly, Category = "Rise")
 	uint8 InitialOwnerPlayerIndex;
 
+	/** Whether the actor is a structure. Killing a structure raises a StructureLost match event for its owner. */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise")
+	bool bIsStructure;
+
 	/** The player that owns this actor. */
 	UPROPERTY(ReplicatedUsing = OnOwnerChangedCallback)
 	ARisePlayerState* Owner;
 
+	/** The player index of the set this component is registered in within the ownership subsystem. */
+	uint8 OwnershipSetIndex;
+
+	/** The slot of this component within its ownership subsystem set, or INDEX_NONE if it is not registered. */
+	int32 OwnershipSlot;
+
+	/** The slot of this component within the initial owner bucket of its initial owner, or INDEX_NONE if it is not registered. */
+	int32 InitialOwnerSlot;
+
 public:	
 	URiseOwnableComponent();
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnReleasedToPool() override;
 
 	/**
 	 * Gets the player that owns this actor.
@@ -39,6 +58,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	ARisePlayerState* GetPlayerOwner() const;
 
+	/**
+	 * Checks whether the actor is a structure.
+	 *
+	 * @return Whether the actor is a structure.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise")
+	bool IsStructure() const;
+
 	/**
 	 * Sets the player that owns this actor.
 	 * 
@@ -55,6 +82,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Rise")
 	void SetPlayerOwnerByPlayerState(ARisePlayerState* NewOwner);
 
+	/**
+	 * Sets the player that owns this actor.
+	 * 
+	 * @param NewOwner The new owner of this actor.
+	 * @param bSuppressPlayerNotification Whether to skip notifying the old and new owners. Used when the caller
+	 *                                    sends one aggregated notification for many actors instead.
+	 */
+	void SetPlayerOwnerByPlayerState(ARisePlayerState* NewOwner, bool bSuppressPlayerNotification);
+
 	/**
 	 * Checks whether the actor is owned by the same player as the specified actor.
 	 * 
@@ -93,6 +129,12 @@ private:
 
 	/**
 	 * Notifies that the owner of the actor has changed.
+	 * 
+	 * @param OldOwner The player who used to own this actor.
+	 * @param NewOwner The player who now owns this actor.
+	 * @param bSuppressPlayerNotification Whether to skip notifying the old and new owners.
 	 */
-	void NotifyOwnerChanged(ARisePlayerState* OldOwner, ARisePlayerState* NewOwner);
+	void NotifyOwnerChanged(ARisePlayerState* OldOwner, ARisePlayerState* NewOwner, bool bSuppressPlayerNotification);
+
+	friend class URiseOwnershipSubsystem;
 };
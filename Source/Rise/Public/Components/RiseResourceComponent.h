@@ -1,19 +1,59 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/ActorComponent.h"
 
+#include "Components/RiseActorComponent.h"
 #include "RiseResource.h"
+#include "RiseResourceTypes.h"
+#include "Subsystems/RiseSchedulerSubsystem.h"
 #include "RiseResourceComponent.generated.h"
 
+class ARiseResourceField;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FRiseResourceGatheredSignature, AActor*, Gatherer, AActor*, Source, URiseResourceComponent*, Component, float, GatheredAmount);
+/**
+ * The amount of resources a single gatherer received from a batched extraction.
+ */
+USTRUCT(BlueprintType)
+struct FRiseResourceGatherResult
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The actor that gathered the resources. */
+	UPROPERTY(BlueprintReadOnly, Category = "Rise")
+	AActor* Gatherer = nullptr;
+
+	/** The number of units the actor gathered. May be fractional when the node has a resource multiplier. */
+	UPROPERTY(BlueprintReadOnly, Category = "Rise")
+	float GatheredAmount = 0.f;
+
+	/** The resource amount the actor gathered, as credited by the economy. */
+	FRiseResourceAmount FixedGatheredAmount = 0;
+};
+
+/**
+ * A queued request to extract resources from a resource node.
+ */
+struct FRiseResourceExtractRequest
+{
+	/** The actor that is gathering resources. */
+	TWeakObjectPtr<AActor> Gatherer;
+
+	/** The desired resource amount to gather. */
+	FRiseResourceAmount DesiredAmount = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FRiseResourceBatchGatheredSignature, AActor*, Source, URiseResourceComponent*, Component, const TArray<FRiseResourceGatherResult>&, GatherResults);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FRiseResourceDepletedSignature, AActor*, ResourceNode, URiseResourceComponent*, ResourceComponent);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FRiseResourceRegrownSignature, AActor*, ResourceNode, URiseResourceComponent*, ResourceComponent);
 
 /**
  * When attached to an actor, allows this actor to grant a resource to a player.
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
-class RISE_API URiseResourceComponent : public UActorComponent
+class RISE_API URiseResourceComponent : public URiseActorComponent
 {
 	GENERATED_BODY()
 
@@ -23,8 +63,11 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Rise")
 	TSubclassOf<URiseResource> ResourceClass;
 
-	/** The amount of resources this node contains. */
-	UPROPERTY(EditDefaultsOnly, Category = "Rise", meta=(ClampMin = 0))
+	/** The resource id of the resource class, resolved when play begins. */
+	FRiseResourceId ResourceId;
+
+	/** The number of whole units of resources this node contains. Limited to what clients can be sent. */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise", meta=(ClampMin = 0, ClampMax = 65535))
 	int32 MaxResourceAmount;
 
 	/**
@@ -36,24 +79,81 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Rise", meta = (ClampMin = 0))
 	float ResourceMultiplier;
 
-	/** The number of resources left in this node. */
+	/** The resource multiplier as a fixed-point factor, converted once when play begins. */
+	FRiseResourceAmount FixedResourceMultiplier;
+
+	/**
+	 * The time in seconds before this node grows back after being depleted, or 0 if it never does.
+	 * Nodes that grow back are hidden while depleted instead of being recycled or destroyed.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise", meta = (ClampMin = 0))
+	float RegrowthDelay;
+
+	/** Whether this node is currently allowed to grow back. */
+	UPROPERTY(EditAnywhere, Category = "Rise")
+	bool bRegrowthEnabled;
+
+	/** Whether this node is depleted and waiting to grow back. */
+	bool bAwaitingRegrowth;
+
+	/** The scheduled regrowth of this node. */
+	FRiseScheduledEventHandle RegrowthHandle;
+
+	/** The time in seconds that was left before this node grew back when its regrowth was paused, or 0. */
+	float RegrowthTimeRemaining;
+
+	/** The resource amount left in this node. Only kept on the server. */
+	FRiseResourceAmount CurrentResourceAmount;
+
+	/**
+	 * The amount left in this node as seen by clients, in whole units rounded up. Only whole unit
+	 * changes are sent, and the owning actor stays dormant between them.
+	 */
 	UPROPERTY(Replicated)
-	float CurrentResourceAmount;
+	uint16 ReplicatedResourceUnits;
 
 	/** Event called when resources have been gathered from this resource node. */
 	UPROPERTY(BlueprintAssignable, Category = "Rise")
 	FRiseResourceGatheredSignature OnResourceGathered;
 
+	/**
+	 * Event called once per economy tick with every extraction that was queued on this resource node.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Rise")
+	FRiseResourceBatchGatheredSignature OnResourceBatchGathered;
+
 	/** Event called when all resources have been gathered from this resource node. */
 	UPROPERTY(BlueprintAssignable, Category = "Rise")
 	FRiseResourceDepletedSignature OnResourceDepleted;
 
+	/** Event called when this resource node has grown back after being depleted. */
+	UPROPERTY(BlueprintAssignable, Category = "Rise")
+	FRiseResourceRegrownSignature OnResourceRegrown;
+
+	/** The extractions queued since the last economy tick, in the order they were queued. */
+	TArray<FRiseResourceExtractRequest> PendingExtractions;
+
+	/** The grid cell this node is registered in within the resource node index. */
+	FIntPoint NodeIndexCell;
+
+	/** The slot of this node within its resource node index cell, or INDEX_NONE if it is not registered. */
+	int32 NodeIndexSlot;
+
+	/** The resource field this node was promoted from, if any. */
+	TWeakObjectPtr<ARiseResourceField> ResourceField;
+
+	/** The instance index of this node within its resource field. */
+	int32 ResourceFieldInstance;
+
 public:
 
 	URiseResourceComponent();
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnReleasedToPool() override;
+	virtual void OnAcquiredFromPool() override;
 
 public:
 
@@ -65,10 +165,17 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	TSubclassOf<URiseResource> GetResourceType() const;
 
+	/**
+	 * Returns the resource id of the resource type that this node contains.
+	 *
+	 * @return The resource id, or RISE_RESOURCE_ID_NONE before play begins.
+	 */
+	FRiseResourceId GetResourceId() const;
+
 	/**
 	 * Returns the maximum amount of this resource that this node contains.
 	 * 
-	 * @return The maximum amount of this resource that this node contains.
+	 * @return The maximum number of whole units that this node contains.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	int32 GetMaxResourceAmount() const;
@@ -76,20 +183,48 @@ public:
 	/**
 	 * Returns the current amount of this resource that this node contains.
 	 * 
-	 * @return The current amount of this resource that this node contains.
+	 * @return The current number of units that this node contains, rounded up to whole units.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	int32 GetCurrentResourceAmount() const;
 
+	/**
+	 * Returns the exact amount of this resource that this node contains.
+	 *
+	 * @return The current resource amount that this node contains. On clients, this is rounded up to whole units.
+	 */
+	FRiseResourceAmount GetFixedResourceAmount() const;
+
 	/**
 	 * Extracts resources from this resource node.
 	 * 
 	 * @param Gatherer The actor that is gathering resources from this resource node.
-	 * @param DesiredAmount The desired amount of resources to gather from this resource node.
-	 * @return The actual amount that was gathered from this resource node.
+	 * @param DesiredAmount The desired number of whole units to gather from this resource node.
+	 * @return The number of units that was gathered from this resource node. May be fractional when the node has a resource multiplier.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Rise")
+	float Extract(AActor* Gatherer, int32 DesiredAmount);
+
+	/**
+	 * Queues an extraction from this resource node. Queued extractions are resolved together on
+	 * the next economy tick, in the order they were queued, and reported through a single
+	 * OnResourceBatchGathered event.
+	 * 
+	 * @param Gatherer The actor that is gathering resources from this resource node.
+	 * @param DesiredAmount The desired number of whole units to gather from this resource node.
+	 * 
+	 * @note Prefer this over Extract() for routine harvesting by many gatherers.
+	 * @note Only has an effect on the server.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Rise")
-	int32 Extract(AActor* Gatherer, int32 DesiredAmount);
+	void QueueExtract(AActor* Gatherer, int32 DesiredAmount);
+
+	/**
+	 * Resolves every queued extraction. Called by the economy subsystem once per economy tick.
+	 * 
+	 * @return The amount each gatherer received.
+	 */
+	TArray<FRiseResourceGatherResult> ResolvePendingExtractions();
 
 	/**
 	 * Checks whether the specified gatherer is able to extract resources from this node.
@@ -99,4 +234,67 @@ public:
 	 */
 	UFUNCTION(BlueprintNativeEvent, Category = "Rise")
 	bool CanGatherFromNode(AActor* Gatherer) const;
+
+	/**
+	 * Allows or prevents this node from growing back after being depleted. A production building
+	 * would enable this while it has workers, for example.
+	 *
+	 * @param bEnabled Whether this node may grow back.
+	 *
+	 * @note Disabling regrowth while the node is waiting to grow back pauses it. Enabling it again
+	 * resumes it with the time that was left.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Rise")
+	void SetRegrowthEnabled(bool bEnabled);
+
+private:
+
+	/**
+	 * Removes resources from this node.
+	 * 
+	 * @param DesiredAmount The desired resource amount, before the resource multiplier is applied.
+	 * @return The resource amount that was removed.
+	 */
+	FRiseResourceAmount Withdraw(FRiseResourceAmount DesiredAmount);
+
+	/**
+	 * Converts a number of whole units requested through the Blueprint API to a resource amount,
+	 * clamping it so it cannot overflow.
+	 */
+	static FRiseResourceAmount UnitsToWithdraw(int32 DesiredUnits);
+
+	/**
+	 * Notifies listeners that this node has been depleted and recycles or destroys the owning actor.
+	 */
+	void NotifyDepleted();
+
+	/**
+	 * Updates the replicated amount of this node and wakes the owning actor for a single net update
+	 * if it changed. Called once after each batch of changes so they are sent together.
+	 */
+	void UpdateReplicatedAmount();
+
+	/**
+	 * Writes the remaining amount of this node back to the resource field it was promoted from.
+	 */
+	void ReturnToResourceField();
+
+	/**
+	 * Schedules this node to grow back if regrowth is enabled, after the time left when it was paused
+	 * or the full regrowth delay.
+	 */
+	void ScheduleRegrowth();
+
+	/**
+	 * Cancels any scheduled regrowth of this node.
+	 */
+	void CancelRegrowth();
+
+	/**
+	 * Refills this node and makes it available to gatherers again.
+	 */
+	void Regrow();
+
+	friend class ARiseResourceField;
+	friend class URiseResourceNodeIndexSubsystem;
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * A blueprint class listed in the class manifest.
+ */
+struct FRiseClassManifestEntry
+{
+	/** The path of the generated class. */
+	FSoftObjectPath ClassPath;
+
+	/** The asset name of the class, matched against class name hints. */
+	FString NameHint;
+};
+
+/**
+ * A compact list of the blueprint classes derived from a set of base classes. The manifest is
+ * generated ahead of cooking by the RiseClassManifest commandlet so cooked builds can look up
+ * content classes without querying the asset registry.
+ */
+struct RISE_API FRiseClassManifest
+{
+public:
+
+	/** The blueprint classes derived from each base class, keyed by the base class path. */
+	TMap<FName, TArray<FRiseClassManifestEntry>> ClassesByBaseClass;
+
+	/**
+	 * Gets the location of the manifest within the project content directory.
+	 *
+	 * @return The manifest filename.
+	 */
+	static FString GetDefaultFilename();
+
+	/**
+	 * Reads the manifest from disk, replacing the current contents.
+	 *
+	 * @param Filename The file to read.
+	 * @return Whether the manifest was read. The manifest is left empty on failure.
+	 */
+	bool LoadFromFile(const FString& Filename);
+
+	/**
+	 * Writes the manifest to disk.
+	 *
+	 * @param Filename The file to write.
+	 * @return Whether the manifest was written.
+	 */
+	bool SaveToFile(const FString& Filename) const;
+
+	/**
+	 * Checks whether the manifest lists the classes of the specified base class.
+	 *
+	 * @param BaseClass The base class.
+	 * @return Whether the manifest can answer lookups for the base class.
+	 */
+	bool ContainsBaseClass(const UClass* BaseClass) const;
+
+	/**
+	 * Gets the classes listed for the specified base class.
+	 *
+	 * @param BaseClass The base class.
+	 * @return The listed classes, or nullptr if the base class is not in the manifest.
+	 */
+	const TArray<FRiseClassManifestEntry>* FindClasses(const UClass* BaseClass) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FRiseClassManifest& Manifest);
+
+private:
+
+	/** Identifies manifest files. */
+	static const uint32 MagicNumber;
+
+	/** The current manifest format. Manifests of any other version are rejected. */
+	static const uint32 Version;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+
+#include "RiseRecipeData.generated.h"
+
+class URiseResource;
+
+/**
+ * A quantity of a single resource consumed or produced by a recipe.
+ */
+USTRUCT(BlueprintType)
+struct FRiseRecipeIngredient
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FRiseRecipeIngredient()
+		: Units(1)
+	{}
+
+	/**
+	 * The type of resource.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TSubclassOf<URiseResource> ResourceType;
+
+	/**
+	 * The number of whole units of the resource per production cycle.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Units;
+};
+
+/**
+ * A production recipe converting input resources into output resources, e.g. Logs into Lumber.
+ */
+USTRUCT(BlueprintType)
+struct FRiseRecipeData : public FTableRowBase
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FRiseRecipeData()
+		: CycleTime(10.f)
+	{}
+
+	/**
+	 * The resources consumed by each production cycle.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FRiseRecipeIngredient> Inputs;
+
+	/**
+	 * The resources produced by each production cycle.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FRiseRecipeIngredient> Outputs;
+
+	/**
+	 * The time in seconds a producer working at full efficiency takes to complete one cycle.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float CycleTime;
+};
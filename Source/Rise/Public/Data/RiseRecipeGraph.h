@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "RiseResourceTypes.h"
+
+class UDataTable;
+class URiseResourceRegistrySubsystem;
+
+/**
+ * A quantity of a single resource consumed or produced by a compiled recipe.
+ */
+struct FRiseRecipeAmount
+{
+	/** The id of the resource. */
+	FRiseResourceId ResourceId = RISE_RESOURCE_ID_NONE;
+
+	/** The amount of the resource per production cycle. */
+	FRiseResourceAmount Amount = 0;
+};
+
+/**
+ * A recipe resolved against the resource registry, ready to be evaluated by the economy.
+ */
+struct FRiseCompiledRecipe
+{
+	/** The name of the data table row the recipe was compiled from. */
+	FName Name;
+
+	/** The resources consumed by each production cycle. Each resource appears at most once. */
+	TArray<FRiseRecipeAmount, TInlineAllocator<2>> Inputs;
+
+	/** The resources produced by each production cycle. Each resource appears at most once. */
+	TArray<FRiseRecipeAmount, TInlineAllocator<2>> Outputs;
+
+	/** The number of economy ticks a producer working at full efficiency takes to complete one cycle. */
+	int32 CycleTicks = 1;
+};
+
+/**
+ * A flat, index-addressed copy of a recipe data table, with the recipes forming a graph over resource ids.
+ *
+ * Recipes are stored in topological order: every recipe comes after the recipes producing its inputs,
+ * so evaluating them by index lets a single pass feed the outputs of one stage of a production chain
+ * (e.g. Logs) straight into the next (e.g. Lumber).
+ */
+struct RISE_API FRiseRecipeGraph
+{
+private:
+
+	/** The compiled recipes, in topological order. */
+	TArray<FRiseCompiledRecipe> Recipes;
+
+	/** Maps each source row name to the index of its compiled recipe. */
+	TMap<FName, int32> RecipeIndices;
+
+	/** The indices of the recipes producing each resource, indexed by resource id. */
+	TArray<TArray<int32>> ProducingRecipes;
+
+public:
+
+	/**
+	 * Compiles the specified data table, replacing the current contents.
+	 *
+	 * @param DataTable The table to compile. Its row struct must be FRiseRecipeData.
+	 * @param ResourceRegistry The registry used to resolve resource types to ids.
+	 * @param EconomyTickInterval The time in seconds between economy ticks, used to convert cycle times to ticks.
+	 * @return Whether the table was compiled.
+	 *
+	 * @note Recipes that form a cycle (directly or through other recipes) cannot be ordered. They are
+	 *       reported and placed after all other recipes, so they run on the stock of the previous tick.
+	 */
+	bool Compile(const UDataTable* DataTable, const URiseResourceRegistrySubsystem* ResourceRegistry, float EconomyTickInterval);
+
+	/**
+	 * Finds the index of the recipe compiled from the specified data table row.
+	 *
+	 * @param RecipeName The name of the data table row.
+	 * @return The index of the recipe, or INDEX_NONE if there is no such recipe.
+	 */
+	int32 FindRecipeIndex(FName RecipeName) const;
+
+	/**
+	 * Gets the indices of the recipes producing the specified resource.
+	 *
+	 * @param ResourceId The id of the resource.
+	 * @return The indices of the recipes. Empty if the resource can only be gathered.
+	 */
+	TArrayView<const int32> GetProducingRecipes(FRiseResourceId ResourceId) const;
+
+	/**
+	 * Gets the specified recipe.
+	 *
+	 * @param RecipeIndex A valid recipe index obtained from this graph.
+	 * @return The recipe.
+	 */
+	const FRiseCompiledRecipe& GetRecipe(int32 RecipeIndex) const
+	{
+		return Recipes[RecipeIndex];
+	}
+
+	/**
+	 * Gets the number of resource types the graph was compiled against.
+	 *
+	 * @return The number of resource types.
+	 */
+	int32 GetNumResourceTypes() const
+	{
+		return ProducingRecipes.Num();
+	}
+
+	/**
+	 * Gets the number of compiled recipes.
+	 *
+	 * @return The number of compiled recipes.
+	 */
+	int32 Num() const
+	{
+		return Recipes.Num();
+	}
+};
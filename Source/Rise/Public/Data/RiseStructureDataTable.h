@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Data/RiseStructureData.h"
+
+class UDataTable;
+
+/**
+ * Identifies a single structure type and level within a compiled structure data table.
+ * Resolve ids once (for example when a structure is built or upgraded) and keep them,
+ * so reading the stats afterwards is a single array index.
+ */
+struct FRiseStructureDataId
+{
+public:
+
+	/** The index of the row within the compiled table. */
+	uint16 Index = MAX_uint16;
+
+	/**
+	 * Whether this id refers to a row.
+	 */
+	bool IsValid() const
+	{
+		return Index != MAX_uint16;
+	}
+
+	bool operator==(const FRiseStructureDataId& Other) const
+	{
+		return Index == Other.Index;
+	}
+
+	bool operator!=(const FRiseStructureDataId& Other) const
+	{
+		return Index != Other.Index;
+	}
+};
+
+/**
+ * The levels of a single structure type within a compiled structure data table.
+ */
+struct FRiseStructureTypeLevels
+{
+	/** The name of the structure type, e.g. CommandStation. */
+	FName TypeName;
+
+	/** The index of the type's first level within the compiled rows. */
+	uint16 FirstRow = 0;
+
+	/** The number of levels of the type. */
+	uint8 NumLevels = 0;
+};
+
+/**
+ * A flat, index-addressed copy of a structure data table.
+ *
+ * Rows are named after the structure type followed by the level, e.g. CommandStation2. The rows
+ * of each type are stored contiguously by level, so an id is simply the index of the row.
+ */
+struct RISE_API FRiseStructureDataTable
+{
+private:
+
+	/** The compiled rows, grouped by type and ordered by level. */
+	TArray<FRiseStructureData> Rows;
+
+	/** The levels of each structure type, sorted by type name. */
+	TArray<FRiseStructureTypeLevels> Types;
+
+	/** Maps each structure type name to its index within Types. */
+	TMap<FName, int32> TypeIndices;
+
+	/** Maps each source row name to the id of its compiled row. */
+	TMap<FName, FRiseStructureDataId> RowIds;
+
+public:
+
+	/**
+	 * Compiles the specified data table, replacing the current contents.
+	 *
+	 * @param DataTable The table to compile. Its row struct must be FRiseStructureData.
+	 * @return Whether the table was compiled.
+	 */
+	bool Compile(const UDataTable* DataTable);
+
+	/**
+	 * Updates this table in place with the rows of another compiled table. This only succeeds when
+	 * both tables have the same types and levels, so existing ids remain valid.
+	 *
+	 * @param NewTable The table to take the rows from.
+	 * @param OutChangedIds The ids of the rows whose stats differ.
+	 * @return Whether the rows were applied. If false, the layouts differ and nothing was changed.
+	 */
+	bool ApplyRows(const FRiseStructureDataTable& NewTable, TArray<FRiseStructureDataId>& OutChangedIds);
+
+	/**
+	 * Finds the id of the specified structure type and level.
+	 *
+	 * @param TypeName The name of the structure type.
+	 * @param Level The level of the structure, starting at 1.
+	 * @return The id of the row, or an invalid id if there is no such row.
+	 */
+	FRiseStructureDataId FindId(FName TypeName, int32 Level) const;
+
+	/**
+	 * Finds the id of the row that was compiled from the specified data table row.
+	 *
+	 * @param RowName The name of the data table row.
+	 * @return The id of the row, or an invalid id if there is no such row.
+	 */
+	FRiseStructureDataId FindIdByRowName(FName RowName) const;
+
+	/**
+	 * Gets the number of levels of the specified structure type.
+	 *
+	 * @param TypeName The name of the structure type.
+	 * @return The number of levels, or 0 if the type is unknown.
+	 */
+	int32 GetNumLevels(FName TypeName) const;
+
+	/**
+	 * Gets the stats of the specified row.
+	 *
+	 * @param Id A valid id obtained from this table.
+	 * @return The stats of the row.
+	 */
+	const FRiseStructureData& Get(FRiseStructureDataId Id) const
+	{
+		return Rows[Id.Index];
+	}
+
+	/**
+	 * Gets the number of compiled rows.
+	 *
+	 * @return The number of compiled rows.
+	 */
+	int32 Num() const
+	{
+		return Rows.Num();
+	}
+
+	/**
+	 * Splits a data table row name into its structure type and level. Names without
+	 * a trailing number are treated as level 1.
+	 *
+	 * @param RowName The name of the row.
+	 * @param OutTypeName The name of the structure type.
+	 * @param OutLevel The level of the structure.
+	 */
+	static void ParseRowName(FName RowName, FName& OutTypeName, int32& OutLevel);
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+
+#include "RiseResourceLibrary.generated.h"
+
+/**
+ * Converts resource amounts for Blueprints. Resource amounts are fixed-point numbers; see
+ * FRiseResourceAmount.
+ */
+UCLASS()
+class RISE_API URiseResourceLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Converts a resource amount to whole units, rounding down.
+	 *
+	 * @param Amount The resource amount.
+	 * @return The number of whole units.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise|Economy")
+	static int32 ResourceAmountToUnits(int32 Amount);
+
+	/**
+	 * Converts a resource amount to a float, for display.
+	 *
+	 * @param Amount The resource amount.
+	 * @return The amount as a float.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise|Economy")
+	static float ResourceAmountToFloat(int32 Amount);
+
+	/**
+	 * Converts a number of whole units to a resource amount.
+	 *
+	 * @param Units The number of whole units.
+	 * @return The resource amount.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise|Economy")
+	static int32 UnitsToResourceAmount(int32 Units);
+};
@@ -3,9 +3,11 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
 #include "Templates/SubclassOf.h"
+#include "UObject/SoftObjectPtr.h"
 
+#include "RisePlayerMask.h"
 #include "RisePlayerState.h"
-#include "Components/RiseOwnableComponent.h"
+#include "Rules/RiseMatchCondition.h"
 #include "RiseGameMode.generated.h"
 
 /**
@@ -19,9 +21,9 @@ struct FRisePlayerUnitSpawnParameters
 public:
 
 	//TODO: Replace this class with the base class for spawnable units.
-	/** The class of the actor to spawn. */
+	/** The class of the actor to spawn. This is loaded asynchronously while the match is loading. */
 	UPROPERTY(EditDefaultsOnly)
-	TSubclassOf<AActor> Unit;
+	TSoftClassPtr<AActor> Unit;
 	
 	/** The local offset location to spawn this unit. */
 	UPROPERTY(EditDefaultsOnly)
@@ -29,122 +31,65 @@ public:
 };
 
 /**
- * The base class for defeat conditions.
+ * A single actor to spawn through the game mode's spawn queue.
  */
 USTRUCT()
-struct FRiseDefeatConditionBase
+struct FRiseSpawnRequest
 {
 	GENERATED_USTRUCT_BODY()
 
 public:
 
-	/**
-	 * Checks whether the deletion of the provided actor would cause a
-	 * defeat for the provided player.
-	 *
-	 * @param AActor The actor that was just killed.
-	 * @param ActorOwner The owner of the actor that was just killed.
-	 * @return Whether the player is defeated.
-	 */
-	virtual bool IsDefeated(AActor* Actor, AController* ActorOwner)
-	{
-		return false;
-	}
+	/** The class of the actor to spawn. Classes that are not loaded yet are loaded synchronously when spawned. */
+	UPROPERTY()
+	TSoftClassPtr<AActor> ActorClass;
+
+	/** The player to receive ownership of the actor. May be null. */
+	UPROPERTY()
+	AController* ActorOwner = nullptr;
+
+	/** The transform of the actor to spawn. */
+	UPROPERTY()
+	FTransform SpawnTransform;
 
 	/**
-	 * Returns the reason why the player was defeated.
-	 *
-	 * @return The reason why the player was defeated.
+	 * The index of the owning player when the request was queued, used to track the player's queued
+	 * spawns even if the owner leaves first. Filled in by EnqueueSpawnRequests().
 	 */
-	virtual FString GetDefeatReason()
-	{
-		return TEXT("");
-	}
+	uint8 PlayerIndex = ARisePlayerState::PLAYER_INDEX_NONE;
 };
 
+DECLARE_DELEGATE_OneParam(FRiseSpawnBatchCompleteDelegate, const TArray<AActor*>& /* SpawnedActors */);
+
 /**
- * A defeat condition that occurs when the player does not have the necessary number of
- * a specific actor under their control.
+ * A group of spawn requests that completes together.
  */
 USTRUCT()
-struct FRiseRequiredUnitsDefeatCondition : public FRiseDefeatConditionBase
+struct FRiseSpawnBatch
 {
 	GENERATED_USTRUCT_BODY()
 
 public:
 
-	/** The type of actor that must be under this player's control. */
-	UPROPERTY(EditDefaultsOnly)
-	TSubclassOf<AActor> ActorClass;
+	/** The actors to spawn. */
+	UPROPERTY()
+	TArray<FRiseSpawnRequest> Requests;
 
-	/** The number of this type of actor that must be under this player's control. */
-	UPROPERTY(EditDefaultsOnly)
-	int32 ActorCount;
+	/** The actors that have been spawned so far. */
+	UPROPERTY()
+	TArray<AActor*> SpawnedActors;
 
-public:
+	/** The index of the next request to spawn. */
+	int32 NextRequestIndex = 0;
 
-	/**
-	 * Checks whether the deletion of the provided actor would cause a
-	 * defeat for the provided player.
-	 * 
-	 * @param AActor The actor that was just killed.
-	 * @param ActorOwner The owner of the actor that was just killed.
-	 * @return Whether the player is defeated.
-	 */
-	bool IsDefeated(AActor* Actor, AController* ActorOwner) override
-	{
-		if (!Actor)
-		{
-			return false;
-		}
-
-		// Double check that the actor owner is valid.
-		ARisePlayerState* PlayerState = nullptr;
-		if (ActorOwner)
-		{
-			PlayerState = Cast<ARisePlayerState>(ActorOwner->PlayerState);
-		}
-		else
-		{
-			URiseOwnableComponent* OwnableComponent = Actor->FindComponentByClass<URiseOwnableComponent>();
-			if (IsValid(OwnableComponent))
-			{
-				PlayerState = OwnableComponent->GetPlayerOwner();
-			}
-		}
-
-		// If we can't get the owner we cannot assume the player is defeated.
-		if (!IsValid(PlayerState))
-		{
-			return false;
-		}
-
-		int32 TargetOwnedActors = 0;
-		for (AActor* OwnedActor : PlayerState->GetOwnedActors())
-		{
-			if (OwnedActor->GetClass()->IsChildOf(ActorClass))
-			{
-				++TargetOwnedActors;
-			}
-		}
-
-		return TargetOwnedActors >= ActorCount;
-	}
-
-	/**
-	 * Returns the reason why the player was defeated.
-	 * 
-	 * @return The reason why the player was defeated.
-	 */
-	virtual FString GetDefeatReason() override
-	{
-		return TEXT("The player does not control the necessary actors.");
-	}
+	/** Called once every request in the batch has been processed. */
+	FRiseSpawnBatchCompleteDelegate OnComplete;
 };
 
 class AAIController;
 class ARisePlayerStart;
 class ARiseTeamInfo;
+struct FStreamableHandle;
 
 /**
  * Common game mode information.
@@ -159,8 +104,11 @@ public:
 	ARiseGameMode();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
 	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
 
+	virtual void Logout(AController* Exiting) override;
 	virtual void RestartPlayer(AController* NewPlayer) override;
 	virtual void RestartPlayerAtPlayerStart(AController* NewPlayer, AActor* StartSpot) override;
 
@@ -176,10 +124,25 @@ private:
 	TArray<FRisePlayerUnitSpawnParameters> PlayerSpawnParameters;
 
 	/** 
-	 * Conditions that would cause a player to lose the game.
+	 * Conditions that would cause a player to win or lose the game.
 	 */
-	UPROPERTY(EditDefaultsOnly, Category = "Rise")
-	TArray<FRiseDefeatConditionBase> DefeatConditions;
+	UPROPERTY(EditDefaultsOnly, Instanced, Category = "Rise")
+	TArray<URiseMatchCondition*> MatchConditions;
+
+	/** The match events raised for each player since the match conditions were last evaluated, indexed by player index. */
+	TArray<ERiseMatchEvent> PendingMatchEvents;
+
+	/** Whether the match has already been decided for each player, indexed by player index. */
+	TBitArray<> DecidedPlayers;
+
+	/** Whether the evaluation interval of each timer-driven match condition has elapsed, indexed by condition. */
+	TBitArray<> DueTimerConditions;
+
+	/** The timers driving timer-dependent match conditions. */
+	TArray<FTimerHandle> MatchConditionTimerHandles;
+
+	/** The handle of the ownership subsystem's OnOwnedActorsChanged binding. */
+	FDelegateHandle OwnedActorsChangedHandle;
 
 	/** The number of teams in this game mode. */
 	UPROPERTY(EditDefaultsOnly, Category = "Rise")
@@ -189,6 +152,21 @@ private:
 	UPROPERTY()
 	TArray<ARiseTeamInfo*> Teams;
 
+	/** The player indices that are currently assigned to a player. */
+	FRisePlayerMask AllocatedPlayerIndices;
+
+	/** Every RisePlayerStart in the world, gathered once in InitGame(). */
+	UPROPERTY()
+	TArray<ARisePlayerStart*> PlayerStarts;
+
+	/** The RisePlayerStart assigned to each player. */
+	UPROPERTY()
+	TMap<AController*, ARisePlayerStart*> PlayerStartsByPlayer;
+
+	/** The RisePlayerStarts that are not assigned to a player, in reverse world order so the first start is popped first. */
+	UPROPERTY()
+	TArray<ARisePlayerStart*> FreePlayerStarts;
+
 	/** The class of the AIController to use for AI players. */
 	UPROPERTY(EditDefaultsOnly, Category = "Rise|AI")
 	TSubclassOf<AAIController> AIPlayerControllerClass;
@@ -197,6 +175,34 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Rise|AI")
 	uint8 NumAIPlayers;
 
+	/**
+	 * The time in milliseconds the spawn queue may spend spawning actors each frame.
+	 * 
+	 * @note At least one actor is spawned per frame while the queue is not empty.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise|Spawning", meta = (ClampMin = "0"))
+	float SpawnFrameBudgetMs;
+
+	/** The spawn batches waiting to be processed, in the order they were queued. */
+	UPROPERTY()
+	TArray<FRiseSpawnBatch> SpawnQueue;
+
+	/** The number of queued spawn requests for each player, indexed by player index. */
+	TArray<int32> PendingSpawnCounts;
+
+	/**
+	 * Additional classes spawned during the match by other systems (e.g. world generation placement)
+	 * that should be loaded before anything is spawned.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise|Spawning")
+	TArray<TSoftClassPtr<AActor>> PreloadClasses;
+
+	/** The handle keeping the preloaded spawn classes in memory. */
+	TSharedPtr<FStreamableHandle> SpawnClassesHandle;
+
+	/** Whether the spawn classes have finished loading. The spawn queue is not processed until they have. */
+	bool bSpawnClassesLoaded;
+
 public:
 
 	/** 
@@ -220,6 +226,34 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Rise")
 	virtual AActor* SpawnActorForPlayer(TSubclassOf<AActor> ActorClass, AController* ActorOwner, const FTransform& SpawnTransform, bool& bOutActorAssignedOwnership);
 
+	/**
+	 * Queues actors to be spawned over the following frames within the spawn frame budget.
+	 * 
+	 * @param Requests The actors to spawn.
+	 * @param OnComplete Called with the spawned actors once every request has been processed.
+	 * 
+	 * @note Match conditions are not evaluated for a player while they have queued spawns.
+	 */
+	void EnqueueSpawnRequests(TArray<FRiseSpawnRequest> Requests, FRiseSpawnBatchCompleteDelegate OnComplete = FRiseSpawnBatchCompleteDelegate());
+
+	/**
+	 * Checks whether the spawn queue has actors waiting to be spawned.
+	 * 
+	 * @return Whether the spawn queue has actors waiting to be spawned.
+	 */
+	bool HasPendingSpawns() const;
+
+	/**
+	 * Checks whether every class referenced by the spawn parameters, match conditions and preload
+	 * classes has finished loading.
+	 * 
+	 * @return Whether the spawn classes have been loaded.
+	 * 
+	 * @note Spawn requests queued before this returns true are held until it does.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise")
+	bool AreSpawnClassesLoaded() const;
+
 	/**
 	 * Attempts to transfer ownership of the specified actor to the specified player.
 	 * 
@@ -232,6 +266,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Rise")
 	bool TransferActorOwnership(AActor* Actor, AController* NewOwner);
 
+	/**
+	 * Attempts to transfer ownership of the specified actors to the specified player. Each affected
+	 * player receives a single aggregated ownership notification instead of one per actor.
+	 * 
+	 * @param Actors The actors to change the owner of.
+	 * @param NewOwner The player to assume control of the specified actors.
+	 * @return The number of actors whose ownership was successfully transferred.
+	 * 
+	 * @note Actors that are not ownable or are already owned by the player are skipped.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Rise")
+	int32 TransferActorsOwnership(const TArray<AActor*>& Actors, AController* NewOwner);
+
 	/**
 	 * Finds the PlayerStart for the specified player.
 	 * 
@@ -267,6 +314,13 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	TArray<ARiseTeamInfo*> GetTeams() const;
 
+	/**
+	 * Gets the teams of the current match without copying them.
+	 * 
+	 * @return The teams of the current match.
+	 */
+	const TArray<ARiseTeamInfo*>& GetTeamsView() const;
+
 	/**
 	 * Notifies the GameMode that an actor has been killed.
 	 * 
@@ -286,6 +340,31 @@ public:
 	 */
 	void NotifyPlayerDefeated(AController* Player);
 
+	/**
+	 * Notifies the GameMode that a player has won.
+	 *
+	 * @param Player The player that won.
+	 */
+	void NotifyPlayerVictorious(AController* Player);
+
+	/**
+	 * Raises a match event for the specified player. Match conditions depending on the event
+	 * are re-evaluated for the player at the end of the frame.
+	 *
+	 * @param PlayerIndex The index of the player the event applies to.
+	 * @param Event The event that occurred.
+	 *
+	 * @note Raising the same event many times in one frame results in a single evaluation.
+	 */
+	void NotifyMatchEvent(uint8 PlayerIndex, ERiseMatchEvent Event);
+
+	/**
+	 * Raises a match event for every player.
+	 *
+	 * @param Event The event that occurred.
+	 */
+	void NotifyMatchEventForAllPlayers(ERiseMatchEvent Event);
+
 	/**
 	 * Notifies the GameMode that a player has resigned.
 	 *
@@ -310,6 +389,14 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Category = "Rise")
 	void OnPlayerDefeated(AController* Player);
 
+	/**
+	 * Event called when a player has won.
+	 *
+	 * @param Player The player that won.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Rise")
+	void OnPlayerVictorious(AController* Player);
+
 	/**
 	 * Event called when a player has resigned.
 	 *
@@ -321,9 +408,64 @@ public:
 protected:
 
 	/**
-	 * Returns the index of the first player slot that isn't assigned to a player.
+	 * Assigns the first player slot that isn't assigned to a player.
+	 * 
+	 * @return The index of the assigned player slot, or PLAYER_INDEX_NONE if every slot is taken.
+	 */
+	uint8 AllocatePlayerIndex();
+
+	/**
+	 * Releases the specified player slot so it can be assigned to another player.
+	 * 
+	 * @param PlayerIndex The index of the player slot to release.
+	 */
+	void FreePlayerIndex(uint8 PlayerIndex);
+
+	/**
+	 * Releases the player slot of a player that is leaving. Everything keyed by the slot (owned actors,
+	 * stockpile, producers, queued spawns and match state) is cleared first, so the next player assigned
+	 * the slot starts fresh.
+	 *
+	 * @param PlayerState The player that is leaving. Its player index is reset to PLAYER_INDEX_NONE.
+	 */
+	void ReleasePlayerIndex(ARisePlayerState* PlayerState);
+
+	/**
+	 * Assigns the specified player to the specified PlayerStart, keeping the PlayerStart table up to date.
+	 * 
+	 * @param PlayerStart The PlayerStart to assign.
+	 * @param Player The player to spawn at the PlayerStart. Specifying null releases the PlayerStart.
+	 */
+	void SetPlayerStartPlayer(ARisePlayerStart* PlayerStart, AController* Player);
+
+	/**
+	 * Attempts to transfer ownership of the specified actor to the specified player.
 	 * 
-	 * @return The index of the first player slot that isn't assigned to a player.
+	 * @param Actor The actor to change the owner of.
+	 * @param NewOwner The player to assume control of the specified actor.
+	 * @param bSuppressNotification Whether to skip logging and notifying the old and new owners.
+	 * @param OutOldOwner Reference passed in to store the player who owned the actor before the transfer.
+	 * @return Whether ownership was successfully transferred.
+	 */
+	bool TransferActorOwnership(AActor* Actor, AController* NewOwner, bool bSuppressNotification, ARisePlayerState*& OutOldOwner);
+
+	/**
+	 * Starts streaming in every class the game mode may spawn during the match.
+	 */
+	void PreloadSpawnClasses();
+
+	/**
+	 * Called once the spawn classes have finished loading. Releases any spawn requests held until now.
+	 */
+	void OnSpawnClassesLoaded();
+
+	/**
+	 * Evaluates the match conditions for every player with pending match events.
+	 */
+	void EvaluateMatchConditions();
+
+	/**
+	 * Spawns queued actors until the spawn frame budget is exhausted.
 	 */
-	uint8 GetAvailablePlayerIndex();
+	void ProcessSpawnQueue();
 };
@@ -1,11 +1,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "AssetRegistry/AssetRegistryModule.h"
 #include "UObject/SoftObjectPtr.h"
 
 #include "RiseMacros.h"
 #include "Components/Metadata/RiseNameComponent.h"
+#include "Subsystems/RiseClassRegistrySubsystem.h"
 
 /**
  * A structure that contains multiple utilities that would not work as macros.
@@ -33,8 +33,8 @@ public:
 
 	/**
 	 * Finds blueprint classes in both editor and cooked packages by content path.
-	 * The resulting UClass references should be cached for reuse as this operation
-	 * is very expensive.
+	 * Lookups are answered from the class registry's in-memory index, so constructing
+	 * a finder is cheap once the registry is ready.
 	 */
 	template<class TBaseClass>
 	struct FBlueprintClassFinder
@@ -42,62 +42,12 @@ public:
 		TSoftClassPtr<TBaseClass> Class;
 		TArray<TSoftClassPtr<TBaseClass>> Classes;
 
-		FBlueprintClassFinder(const TCHAR* ContentPath, const TCHAR* ClassNameHint = NULL, const TCHAR* AssetRegistryModule = TEXT("AssetRegistry"))
+		FBlueprintClassFinder(const TCHAR* ContentPath, const TCHAR* ClassNameHint = NULL)
 		{
-			IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryModule).Get();
-
-			// The asset registry contents may not be in memory at this point.
-			// Scan them just to be safe.
-			TArray<FString> ContentPaths;
-			ContentPaths.Add(FString(ContentPath));
-			AssetRegistry.ScanPathsSynchronous(ContentPaths);
-
-			FName BaseClassName = TBaseClass::StaticClass()->GetFName();
-			TSet<FName> DerivedNames;
-			{
-				TArray<FName> BaseNames;
-				BaseNames.Add(BaseClassName);
-
-				TSet<FName> Excluded;
-				AssetRegistry.GetDerivedClassNames(BaseNames, Excluded, DerivedNames);
-			}
-
-			// Create the asset registry filter. We are looking specifically for UBlueprints.
-			FARFilter Filter;
-			Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
-			Filter.bRecursiveClasses = true;
-			Filter.bRecursivePaths = true;
-
-			// Get a list of UBlueprint assets.
-			TArray<FAssetData> AssetList;
-			AssetRegistry.GetAssets(Filter, AssetList);
-
-			// For each asset in the asset list...
-			for (auto const& Asset : AssetList)
+			URiseClassRegistrySubsystem* ClassRegistry = URiseClassRegistrySubsystem::Get();
+			if (ClassRegistry)
 			{
-				// Determine whether the asset is a generated class.
-				FString GeneratedClassPathPtr = Asset.TagsAndValues.FindTag(TEXT("GeneratedClass")).AsString();
-				if (!GeneratedClassPathPtr.IsEmpty())
-				{
-					// The class name and object path differs between editor and cooked builds.
-					// This will allow us to get the correct class name regardless of where this method
-					// is called. This is essentially work that is done in AssetRegistry.GetDerivedClassNames()
-					// which was called above.
-					const FString ClassObjectPath = FPackageName::ExportTextPathToObjectPath(*GeneratedClassPathPtr);
-					const FString ClassName = FPackageName::ObjectPathToObjectName(ClassObjectPath);
-
-					// If this class is not a class we are looking for, skip it.
-					if (!DerivedNames.Contains(*ClassName))
-					{
-						continue;
-					}
-
-					FSoftObjectPath SoftObjectPath(ClassObjectPath);
-					if (ClassNameHint == NULL || SoftObjectPath.GetAssetName().Contains(ClassNameHint))
-					{
-						Classes.Add(TSoftClassPtr<TBaseClass>(SoftObjectPath));
-					}
-				}
+				Classes = ClassRegistry->FindBlueprintClasses<TBaseClass>(ContentPath, ClassNameHint);
 			}
 
 			if (!Classes.IsEmpty())
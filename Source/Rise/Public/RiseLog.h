@@ -2,4 +2,4 @@
 
 #include "CoreMinimal.h"
 
-DECLARE_LOG_CATEGORY_EXTERN(LogRise, Log, All);
\ No newline at end of file
+RISE_API DECLARE_LOG_CATEGORY_EXTERN(LogRise, Log, All);
\ No newline at end of file
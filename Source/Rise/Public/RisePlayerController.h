@@ -110,8 +110,6 @@ protected:
 public:
 
 	virtual void PlayerTick(float DeltaTime) override;
-	virtual void InitPlayerState() override;
-	virtual void OnRep_PlayerState() override;
 	virtual void GameHasEnded(AActor* EndGameFocus = NULL, bool bIsWinner = false) override;
 
 	/**
@@ -146,6 +144,13 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	TArray<AActor*> GetSelectedActors() const;
 
+	/**
+	 * Gets the actors that are currently selected by this player without copying them.
+	 * 
+	 * @return The actors that are currently selected by this player.
+	 */
+	const TArray<AActor*>& GetSelectedActorsView() const;
+
 	/**
 	 * Causes this player to deselect the specified actor.
 	 *
@@ -317,6 +322,23 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Rise")
 	void OnActorOwnerChanged(AActor* Actor);
 
+	/**
+	 * Notifies this player that many actors have changed ownership at once.
+	 *
+	 * @param GainedActors The actors this player now owns.
+	 * @param LostActors The actors this player no longer owns.
+	 */
+	virtual void NotifyActorsOwnerChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors);
+
+	/**
+	 * Event called when many actors have changed ownership at once.
+	 *
+	 * @param GainedActors The actors this player now owns.
+	 * @param LostActors The actors this player no longer owns.
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Rise")
+	void OnActorsOwnerChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors);
+
 	/**
 	 * Notifies this player that an error has occurred.
 	 *
@@ -459,13 +481,6 @@ public:
 
 protected:
 
-	/**
-	 * Event called when the PlayerState is created, replicated, and ready for use.
-	 * 
-	 * @param NewPlayerState The ready-to-use PlayerState of this player.
-	 */
-	virtual void OnPlayerStateAvailable(ARisePlayerState* NewPlayerState);
-
 	/**
 	 * Starts the selection frame for selecting units.
 	 * 
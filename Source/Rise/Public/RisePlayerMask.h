@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "RisePlayerMask.generated.h"
+
+/**
+ * A fixed-capacity set of player indices stored as a bitmask.
+ */
+USTRUCT()
+struct RISE_API FRisePlayerMask
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The number of player indices the mask can hold. */
+	static constexpr int32 Capacity = 256;
+
+	/** The number of 64-bit words backing the mask. */
+	static constexpr int32 NumWords = Capacity / 64;
+
+private:
+
+	/** The bits of the mask. Bit N represents player index N. */
+	UPROPERTY()
+	uint64 Words[NumWords];
+
+public:
+
+	FRisePlayerMask()
+	{
+		Reset();
+	}
+
+	/**
+	 * Adds the specified player index to the mask.
+	 */
+	FORCEINLINE void Add(uint8 PlayerIndex)
+	{
+		Words[PlayerIndex >> 6] |= (uint64(1) << (PlayerIndex & 63));
+	}
+
+	/**
+	 * Removes the specified player index from the mask.
+	 */
+	FORCEINLINE void Remove(uint8 PlayerIndex)
+	{
+		Words[PlayerIndex >> 6] &= ~(uint64(1) << (PlayerIndex & 63));
+	}
+
+	/**
+	 * Checks whether the specified player index is in the mask.
+	 */
+	FORCEINLINE bool Contains(uint8 PlayerIndex) const
+	{
+		return (Words[PlayerIndex >> 6] & (uint64(1) << (PlayerIndex & 63))) != 0;
+	}
+
+	/**
+	 * Checks whether this mask shares at least one player index with the specified mask.
+	 */
+	bool Intersects(const FRisePlayerMask& Other) const
+	{
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			if (Words[WordIndex] & Other.Words[WordIndex])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Returns the lowest player index that is not in the mask.
+	 * 
+	 * @param MaxPlayerIndex The exclusive upper bound of the indices to consider.
+	 * @return The lowest free player index, or INDEX_NONE if every index below MaxPlayerIndex is taken.
+	 */
+	int32 FindFirstFree(int32 MaxPlayerIndex = Capacity) const
+	{
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			uint64 FreeBits = ~Words[WordIndex];
+			if (FreeBits)
+			{
+				int32 PlayerIndex = WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(FreeBits));
+				return PlayerIndex < MaxPlayerIndex ? PlayerIndex : INDEX_NONE;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+	/**
+	 * Returns the number of player indices in the mask.
+	 */
+	int32 Num() const
+	{
+		int32 Count = 0;
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			Count += static_cast<int32>(FMath::CountBits(Words[WordIndex]));
+		}
+
+		return Count;
+	}
+
+	/**
+	 * Removes every player index from the mask.
+	 */
+	void Reset()
+	{
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			Words[WordIndex] = 0;
+		}
+	}
+};
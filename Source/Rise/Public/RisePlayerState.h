@@ -2,9 +2,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerState.h"
+#include "Templates/SubclassOf.h"
+
+#include "RiseResourceTypes.h"
 #include "RisePlayerState.generated.h"
 
 class ARiseTeamInfo;
+class URiseResource;
 
 /**
  * Common player state information.
@@ -21,6 +25,7 @@ public:
 	ARisePlayerState();
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitializeComponents() override;
 
 public:
 
@@ -85,11 +90,13 @@ public:
 	TArray<AActor*> GetOwnedActors() const;
 
 	/**
-	 * Looks for actors this player owns.
+	 * Returns a view of the actors owned by this player without copying them.
+	 * 
+	 * @return The ownable actors owned by this player.
 	 * 
-	 * @note This is an expensive operation.
+	 * @note The view is invalidated by any ownership change. Do not transfer ownership while iterating it.
 	 */
-	void DiscoverOwnedActors();
+	TArrayView<AActor* const> GetOwnedActorsView() const;
 
 	/**
 	 * Notifies this player state that the player's team has changed.
@@ -125,12 +132,68 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Rise")
 	void OnActorOwnershipChanged(AActor* AffectedActor, ARisePlayerState* OldOwner, ARisePlayerState* NewOwner);
 
+	/**
+	 * Notifies this player state that ownership of many actors has changed at once.
+	 * 
+	 * @param GainedActors The actors this player now owns.
+	 * @param LostActors The actors this player no longer owns.
+	 */
+	virtual void NotifyActorsOwnershipChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors);
+
+	/**
+	 * The event that gets called when ownership of many actors has changed at once.
+	 *
+	 * @param GainedActors The actors this player now owns.
+	 * @param LostActors The actors this player no longer owns.
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Rise")
+	void OnActorsOwnershipChanged(const TArray<AActor*>& GainedActors, const TArray<AActor*>& LostActors);
+
+	/**
+	 * Gets the amount of a resource this player has.
+	 * 
+	 * @param ResourceType The resource.
+	 * @return The number of units in this player's stockpile. May be fractional.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise|Economy")
+	float GetResourceAmount(TSubclassOf<URiseResource> ResourceType) const;
+
+	/**
+	 * Gets this player's stockpile.
+	 * 
+	 * @return The amount of each resource this player has, indexed by resource id.
+	 */
+	const TArray<FRiseResourceAmount>& GetResourceStockpile() const;
+
+	/**
+	 * Updates this player's replicated stockpile. Called by the economy subsystem once per economy tick.
+	 * 
+	 * @param NewStockpile The amount of each resource the player has, indexed by resource id.
+	 * @param Deltas The resources that changed during the economy tick.
+	 */
+	void SetResourceStockpile(TArrayView<const FRiseResourceAmount> NewStockpile, const TArray<FRiseResourceDelta>& Deltas);
+
+	/**
+	 * Notifies this player state that the player's stockpile has changed.
+	 * 
+	 * @param Deltas The resources that changed.
+	 */
+	virtual void NotifyResourceStockpileChanged(const TArray<FRiseResourceDelta>& Deltas);
+
+	/**
+	 * The event that gets called when the player's stockpile has changed. This is called at most once per economy tick.
+	 *
+	 * @param Deltas The resources that changed.
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Rise|Economy")
+	void OnResourceStockpileChanged(const TArray<FRiseResourceDelta>& Deltas);
+
 private:
 
 	/**
 	 * The index of the player.
 	 */
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnPlayerIndexChangedCallback)
 	uint8 PlayerIndex;
 
 	/**
@@ -140,11 +203,31 @@ private:
 	ARiseTeamInfo* Team;
 
 	/**
-	 * The actors this player owns.
+	 * The amount of each resource the player has, indexed by resource id. This mirrors the
+	 * economy subsystem's ledger and is only replicated to the owning player.
 	 */
-	UPROPERTY()
-	TArray<AActor*> OwnedActors;
+	UPROPERTY(ReplicatedUsing = OnResourceStockpileChangedCallback)
+	TArray<int32> ResourceStockpile;
+
+	/**
+	 * The checksum of the server's resource id table. Clients compare it with their own, as the
+	 * stockpile is indexed by resource id.
+	 */
+	UPROPERTY(ReplicatedUsing = OnResourceTypesChecksumChangedCallback)
+	uint32 ResourceTypesChecksum;
+
+	/** Whether the server's resource id table differs from this client's, so the stockpile cannot be read. */
+	bool bResourceTypesMismatch;
 
 	UFUNCTION()
 	void OnTeamChangedCallback();
+
+	UFUNCTION()
+	void OnPlayerIndexChangedCallback(uint8 OldPlayerIndex);
+
+	UFUNCTION()
+	void OnResourceStockpileChangedCallback(const TArray<int32>& OldResourceStockpile);
+
+	UFUNCTION()
+	void OnResourceTypesChecksumChangedCallback();
 };
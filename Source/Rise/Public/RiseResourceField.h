@@ -0,0 +1,181 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "RiseResourceTypes.h"
+#include "Subsystems/RiseSchedulerSubsystem.h"
+#include "RiseResourceField.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class URiseResource;
+class URiseResourceComponent;
+
+/**
+ * A node of a resource field that has been promoted to a full resource node actor.
+ */
+USTRUCT()
+struct FRisePromotedInstance
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The actor the node was promoted to. */
+	UPROPERTY()
+	AActor* Actor = nullptr;
+
+	/** The resource amount left in the node when its idle check was scheduled. */
+	FRiseResourceAmount IdleCheckAmount = 0;
+
+	/** The scheduled check for whether the node has been left alone. */
+	FRiseScheduledEventHandle IdleCheckHandle;
+};
+
+/**
+ * A large group of identical resource nodes, such as a forest, drawn as instances of a single mesh.
+ *
+ * Untouched nodes cost one mesh instance and one packed amount each. When gameplay needs to
+ * interact with a node, the field promotes it to a full resource node actor at the instance's
+ * location, so gameplay code always deals with a regular URiseResourceComponent. When the actor goes
+ * away, its remaining amount is written back to the field and the instance reappears, unless the
+ * node was depleted. Promoted nodes nobody has gathered from for a while are demoted again.
+ *
+ * Untouched nodes are registered with the resource node index one instance at a time, so searches
+ * and density maps see them like any other node.
+ */
+UCLASS()
+class RISE_API ARiseResourceField : public AActor
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The instances of the nodes in this field. */
+	UPROPERTY(VisibleAnywhere, Category = "Rise")
+	UHierarchicalInstancedStaticMeshComponent* InstancesComponent;
+
+	/** The actor a node is promoted to. Must have a URiseResourceComponent. */
+	UPROPERTY(EditAnywhere, Category = "Rise")
+	TSubclassOf<AActor> NodeClass;
+
+	/** The class of resource the nodes contain. Must match the resource component of the node class. */
+	UPROPERTY(EditAnywhere, Category = "Rise")
+	TSubclassOf<URiseResource> ResourceClass;
+
+	/** The resource id of the resource class, resolved when play begins. */
+	FRiseResourceId ResourceId;
+
+	/** The time in seconds a promoted node must go without being gathered from before it is demoted, or 0 to keep it promoted. */
+	UPROPERTY(EditAnywhere, Category = "Rise", meta = (ClampMin = 0))
+	float PromotedIdleTime;
+
+	/** The number of whole units of resources each node starts with. */
+	UPROPERTY(EditAnywhere, Category = "Rise", meta = (ClampMin = 1, ClampMax = 65535))
+	int32 InitialResourceAmount;
+
+	/** The resource amount left in each node, indexed by instance index. Only kept on the server. */
+	TArray<FRiseResourceAmount> InstanceAmounts;
+
+	/**
+	 * One bit per instance, set for the instances that are not drawn because they are depleted or
+	 * promoted. Packed into words so hiding or showing an instance replicates a single word.
+	 */
+	UPROPERTY(ReplicatedUsing = OnHiddenInstancesCallback)
+	TArray<uint32> HiddenInstanceBits;
+
+	/** The hidden instance bits that have been applied to the instances locally. */
+	TArray<uint32> AppliedHiddenInstanceBits;
+
+	/** The original transforms of the hidden instances, so they can be shown again. */
+	TMap<int32, FTransform> HiddenInstanceTransforms;
+
+	/** The grid cell each instance is registered in within the resource node index. */
+	TArray<FIntPoint> InstanceNodeIndexCells;
+
+	/** The slot of each instance within its resource node index cell, or INDEX_NONE if it is not registered. */
+	TArray<int32> InstanceNodeIndexSlots;
+
+	/** The nodes that have been promoted, keyed by instance index. */
+	UPROPERTY()
+	TMap<int32, FRisePromotedInstance> PromotedInstances;
+
+public:
+
+	ARiseResourceField();
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Promotes the specified node to a full resource node actor.
+	 *
+	 * @param InstanceIndex The instance index of the node.
+	 * @return The resource component of the node's actor, or nullptr if the node is depleted or this is not the server.
+	 *
+	 * @note Promoting a node that is already promoted returns its existing actor.
+	 */
+	URiseResourceComponent* PromoteInstance(int32 InstanceIndex);
+
+	/**
+	 * Returns the specified node to the field, removing its actor.
+	 *
+	 * @param InstanceIndex The instance index of the node.
+	 */
+	void DemoteInstance(int32 InstanceIndex);
+
+	/**
+	 * Gets the amount of resources left in the specified node.
+	 *
+	 * @param InstanceIndex The instance index of the node.
+	 * @return The resource amount left in the node.
+	 */
+	FRiseResourceAmount GetInstanceResourceAmount(int32 InstanceIndex) const;
+
+	/**
+	 * Gets the resource component hit by a trace, promoting a field node if one was hit.
+	 *
+	 * @param Hit The result of the trace.
+	 * @return The resource component that was hit, or nullptr if the trace did not hit a resource node.
+	 */
+	static URiseResourceComponent* GetResourceComponentFromHit(const FHitResult& Hit);
+
+private:
+
+	/**
+	 * Writes the remaining amount of a promoted node back to the field. Called by the node's resource
+	 * component when its actor is released or removed.
+	 *
+	 * @param InstanceIndex The instance index of the node.
+	 * @param ResourceAmount The resource amount left in the node.
+	 */
+	void ReturnInstance(int32 InstanceIndex, FRiseResourceAmount ResourceAmount);
+
+	/**
+	 * Sets whether the specified instance is hidden on every machine.
+	 */
+	void SetInstanceHiddenBit(int32 InstanceIndex, bool bHidden);
+
+	/**
+	 * Hides or shows the specified instance locally. Visible instances are registered with the
+	 * resource node index, and hidden ones are not.
+	 */
+	void SetInstanceHidden(int32 InstanceIndex, bool bHidden);
+
+	/**
+	 * Schedules a check for whether the specified promoted node has been left alone.
+	 */
+	void ScheduleIdleCheck(int32 InstanceIndex);
+
+	/**
+	 * Demotes the specified promoted node if it has not been gathered from since its idle check was scheduled.
+	 */
+	void OnPromotedInstanceIdle(int32 InstanceIndex);
+
+	UFUNCTION()
+	void OnHiddenInstancesCallback();
+
+	friend class URiseResourceComponent;
+	friend class URiseResourceNodeIndexSubsystem;
+};
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "Templates/SubclassOf.h"
+
+#include "RiseResource.h"
+#include "RiseResourceTypes.generated.h"
+
+/**
+ * A compact identifier for a resource type, assigned by the resource registry. Resource ids index
+ * directly into stockpiles and other per-resource arrays.
+ */
+typedef uint16 FRiseResourceId;
+
+/** Identifies no resource type. */
+const FRiseResourceId RISE_RESOURCE_ID_NONE = MAX_uint16;
+
+/**
+ * A quantity of a resource, as a fixed-point number with RISE_RESOURCE_AMOUNT_FRACTION_BITS
+ * fractional bits. All resource math is done on these integers so that every machine arrives at
+ * exactly the same amounts. Only values authored by designers are in whole units.
+ */
+typedef int32 FRiseResourceAmount;
+
+/** The number of fractional bits of a resource amount. */
+const int32 RISE_RESOURCE_AMOUNT_FRACTION_BITS = 8;
+
+/** A single whole unit of a resource. */
+const FRiseResourceAmount RISE_RESOURCE_AMOUNT_ONE = 1 << RISE_RESOURCE_AMOUNT_FRACTION_BITS;
+
+/**
+ * Conversions and arithmetic for resource amounts.
+ */
+struct RISE_API FRiseResourceMath
+{
+public:
+
+	/**
+	 * Converts a number of whole units to a resource amount.
+	 */
+	static FRiseResourceAmount FromUnits(int32 Units)
+	{
+		return Units * RISE_RESOURCE_AMOUNT_ONE;
+	}
+
+	/**
+	 * Converts a resource amount to whole units, rounding down.
+	 */
+	static int32 ToUnits(FRiseResourceAmount Amount)
+	{
+		return Amount >> RISE_RESOURCE_AMOUNT_FRACTION_BITS;
+	}
+
+	/**
+	 * Converts an authored value to a resource amount. Only use this on data that is the same on every
+	 * machine, never on simulated values.
+	 */
+	static FRiseResourceAmount FromFloat(float Value)
+	{
+		return FMath::RoundToInt(Value * RISE_RESOURCE_AMOUNT_ONE);
+	}
+
+	/**
+	 * Converts a resource amount to a float, for display only.
+	 */
+	static float ToFloat(FRiseResourceAmount Amount)
+	{
+		return static_cast<float>(Amount) / RISE_RESOURCE_AMOUNT_ONE;
+	}
+
+	/**
+	 * Multiplies a resource amount by a fixed-point factor, rounding towards zero.
+	 */
+	static FRiseResourceAmount Multiply(FRiseResourceAmount Amount, FRiseResourceAmount Factor)
+	{
+		return static_cast<FRiseResourceAmount>((static_cast<int64>(Amount) * Factor) / RISE_RESOURCE_AMOUNT_ONE);
+	}
+};
+
+/**
+ * A set of resource types, stored as one bit per resource id.
+ */
+struct RISE_API FRiseResourceFilter
+{
+private:
+
+	/** Whether each resource type is in the set, indexed by resource id. */
+	TBitArray<> Bits;
+
+public:
+
+	/**
+	 * Adds a resource type to the set.
+	 *
+	 * @param ResourceId The id of the resource type.
+	 */
+	void Add(FRiseResourceId ResourceId)
+	{
+		if (ResourceId == RISE_RESOURCE_ID_NONE)
+		{
+			return;
+		}
+
+		if (ResourceId >= Bits.Num())
+		{
+			Bits.Add(false, ResourceId + 1 - Bits.Num());
+		}
+
+		Bits[ResourceId] = true;
+	}
+
+	/**
+	 * Removes a resource type from the set.
+	 *
+	 * @param ResourceId The id of the resource type.
+	 */
+	void Remove(FRiseResourceId ResourceId)
+	{
+		if (Bits.IsValidIndex(ResourceId))
+		{
+			Bits[ResourceId] = false;
+		}
+	}
+
+	/**
+	 * Checks whether a resource type is in the set.
+	 *
+	 * @param ResourceId The id of the resource type.
+	 * @return Whether the resource type is in the set.
+	 */
+	bool Contains(FRiseResourceId ResourceId) const
+	{
+		return Bits.IsValidIndex(ResourceId) && Bits[ResourceId];
+	}
+
+	/**
+	 * Checks whether the set contains no resource types.
+	 *
+	 * @return Whether the set is empty.
+	 */
+	bool IsEmpty() const
+	{
+		return Bits.Find(true) == INDEX_NONE;
+	}
+
+	/**
+	 * Checks whether this set shares any resource type with another set.
+	 *
+	 * @param Other The other set.
+	 * @return Whether the sets intersect.
+	 */
+	bool Intersects(const FRiseResourceFilter& Other) const
+	{
+		for (TConstSetBitIterator<> It(Bits); It; ++It)
+		{
+			if (Other.Bits.IsValidIndex(It.GetIndex()) && Other.Bits[It.GetIndex()])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Adds every resource type of another set to this set.
+	 *
+	 * @param Other The other set.
+	 */
+	void Union(const FRiseResourceFilter& Other)
+	{
+		Bits.CombineWithBitwiseOR(Other.Bits, EBitwiseOperatorFlags::MaxSize);
+	}
+
+	/**
+	 * Removes every resource type that is not also in another set.
+	 *
+	 * @param Other The other set.
+	 */
+	void Intersect(const FRiseResourceFilter& Other)
+	{
+		Bits.CombineWithBitwiseAND(Other.Bits, EBitwiseOperatorFlags::MaintainSize);
+	}
+
+	/**
+	 * Calls the specified function with the id of each resource type in the set, in id order.
+	 *
+	 * @param Function The function to call.
+	 */
+	template<typename FunctionType>
+	void ForEach(FunctionType Function) const
+	{
+		for (TConstSetBitIterator<> It(Bits); It; ++It)
+		{
+			Function(static_cast<FRiseResourceId>(It.GetIndex()));
+		}
+	}
+};
+
+/**
+ * The change in a player's stockpile of a single resource over one economy tick.
+ */
+USTRUCT(BlueprintType)
+struct FRiseResourceDelta
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The resource that changed. */
+	UPROPERTY(BlueprintReadOnly, Category = "Rise")
+	TSubclassOf<URiseResource> ResourceType;
+
+	/** The number of units the stockpile changed by. May be fractional. */
+	UPROPERTY(BlueprintReadOnly, Category = "Rise")
+	float Delta = 0.f;
+
+	/** The number of units in the stockpile after the change. May be fractional. */
+	UPROPERTY(BlueprintReadOnly, Category = "Rise")
+	float NewAmount = 0.f;
+
+	/** The resource amount the stockpile changed by. */
+	FRiseResourceAmount FixedDelta = 0;
+
+	/** The resource amount in the stockpile after the change. */
+	FRiseResourceAmount FixedNewAmount = 0;
+
+	/** The id of the resource that changed. */
+	FRiseResourceId ResourceId = RISE_RESOURCE_ID_NONE;
+};
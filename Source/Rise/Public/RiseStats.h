@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Rise"), STATGROUP_Rise, STATCAT_Advanced);
+
+/** The number of arrays copied by the Blueprint-facing accessors this frame. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blueprint Array Copies"), STAT_RiseBlueprintArrayCopies, STATGROUP_Rise, RISE_API);
+
+/** The number of elements copied by the Blueprint-facing accessors this frame. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blueprint Array Elements Copied"), STAT_RiseBlueprintArrayElementsCopied, STATGROUP_Rise, RISE_API);
+
+/** The estimated bytes per second sent to all client connections replicating resource node amounts, updated once per second. */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Resource Replication Bytes/s"), STAT_RiseResourceReplicationBytesPerSecond, STATGROUP_Rise, RISE_API);
+
+/** The number of resource node amount changes this frame, each sent once to every client connection. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resource Replication Updates"), STAT_RiseResourceReplicationUpdates, STATGROUP_Rise, RISE_API);
+
+/**
+ * Records a copy of the specified array made by a Blueprint-facing accessor.
+ */
+#define RISE_COUNT_ARRAY_COPY(Array) \
+	INC_DWORD_STAT(STAT_RiseBlueprintArrayCopies); \
+	INC_DWORD_STAT_BY(STAT_RiseBlueprintArrayElementsCopied, (Array).Num())
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Info.h"
+
+#include "RisePlayerMask.h"
 #include "RiseTeamInfo.generated.h"
 
 /**
@@ -45,6 +47,32 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	bool IsOnTeam(AController* Player) const;
 
+	/**
+	 * Checks whether the player with the specified index is on this team.
+	 * 
+	 * @param PlayerIndex The index of the player to check for.
+	 * @return Whether the player with the specified index is on this team.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Rise")
+	bool IsPlayerIndexOnTeam(uint8 PlayerIndex) const;
+
+	/**
+	 * Gets the indices of the players on this team.
+	 * 
+	 * @return A mask of the indices of the players on this team.
+	 */
+	const FRisePlayerMask& GetPlayerMask() const;
+
+	/**
+	 * Moves a player on this team to their new index in the mask of players on this team.
+	 *
+	 * @param OldPlayerIndex The previous index of the player, or PLAYER_INDEX_NONE.
+	 * @param NewPlayerIndex The new index of the player, or PLAYER_INDEX_NONE.
+	 *
+	 * @note Only has an effect on the server.
+	 */
+	void NotifyPlayerIndexChanged(uint8 OldPlayerIndex, uint8 NewPlayerIndex);
+
 	/**
 	 * Gets the players on this team.
 	 * 
@@ -53,6 +81,13 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Rise")
 	TArray<AController*> GetTeamPlayers() const;
 
+	/**
+	 * Gets the players on this team without copying them.
+	 * 
+	 * @return The players on this team.
+	 */
+	const TArray<AController*>& GetTeamPlayersView() const;
+
 	/**
 	 * Gets the index of this team.
 	 * 
@@ -78,4 +113,8 @@ private:
 	/** The players on this team. */
 	UPROPERTY()
 	TArray<AController*> TeamPlayers;
+
+	/** The indices of the players on this team. */
+	UPROPERTY(Replicated)
+	FRisePlayerMask PlayerMask;
 };
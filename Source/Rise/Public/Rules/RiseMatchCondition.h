@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+#include "RiseMatchCondition.generated.h"
+
+class ARiseGameMode;
+class ARisePlayerState;
+
+/**
+ * The events a match condition can depend on. A condition is only re-evaluated for
+ * a player when one of the events it depends on has been raised for that player.
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ERiseMatchEvent : uint8
+{
+	None = 0 UMETA(Hidden),
+	/** The number or type of actors owned by the player has changed. */
+	OwnershipChanged = 1 << 0,
+	/** The condition's evaluation interval has elapsed. */
+	Timer = 1 << 1,
+	/** The player has lost a structure, i.e. an actor whose ownable component is marked as a structure was killed. */
+	StructureLost = 1 << 2
+};
+ENUM_CLASS_FLAGS(ERiseMatchEvent);
+
+/**
+ * The outcome of evaluating a match condition for a player.
+ */
+UENUM(BlueprintType)
+enum class ERiseMatchConditionResult : uint8
+{
+	/** The condition does not decide the match for the player. */
+	None,
+	/** The player has been defeated. */
+	Defeated,
+	/** The player has won. */
+	Victorious
+};
+
+/**
+ * The base class for conditions that decide whether a player has won or lost the game.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class RISE_API URiseMatchCondition : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Prepares the condition for the match. This is called once before the condition is first evaluated.
+	 * 
+	 * @param GameMode The game mode that owns this condition.
+	 */
+	virtual void InitializeCondition(ARiseGameMode* GameMode);
+
+	/**
+	 * Returns the events this condition depends on.
+	 * 
+	 * @return The events that cause this condition to be re-evaluated.
+	 */
+	virtual ERiseMatchEvent GetDependentEvents() const;
+
+	/**
+	 * Returns how often this condition should be re-evaluated when it depends on ERiseMatchEvent::Timer.
+	 * 
+	 * @return The evaluation interval in seconds.
+	 */
+	virtual float GetEvaluationInterval() const;
+
+	/**
+	 * Evaluates this condition for the specified player.
+	 * 
+	 * @param Player The player to evaluate the condition for.
+	 * @return Whether the condition decides the match for the player.
+	 */
+	virtual ERiseMatchConditionResult Evaluate(const ARisePlayerState* Player) const;
+
+	/**
+	 * Returns the reason why the condition decided the match for a player.
+	 * 
+	 * @return The reason why the condition decided the match.
+	 */
+	virtual FString GetResultReason() const;
+
+	/**
+	 * Adds the classes this condition may cause to be spawned or inspected to the specified list, so
+	 * they can be loaded before the match starts.
+	 * 
+	 * @param OutClassPaths The list to add the class paths to.
+	 */
+	virtual void GetPreloadClasses(TArray<FSoftObjectPath>& OutClassPaths) const;
+};
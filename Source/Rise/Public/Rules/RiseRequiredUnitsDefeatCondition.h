@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "Rules/RiseMatchCondition.h"
+#include "RiseRequiredUnitsDefeatCondition.generated.h"
+
+/**
+ * A defeat condition that occurs when the player does not have the necessary number of
+ * a specific actor under their control.
+ */
+UCLASS()
+class RISE_API URiseRequiredUnitsDefeatCondition : public URiseMatchCondition
+{
+	GENERATED_BODY()
+
+private:
+
+	/**
+	 * The type of actor that must be under this player's control. Loaded with the other preloaded
+	 * classes before the match starts.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise")
+	TSoftClassPtr<AActor> ActorClass;
+
+	/** The number of this type of actor that must be under this player's control. */
+	UPROPERTY(EditDefaultsOnly, Category = "Rise", meta = (ClampMin = 0))
+	int32 ActorCount;
+
+public:
+
+	URiseRequiredUnitsDefeatCondition();
+
+	virtual void InitializeCondition(ARiseGameMode* GameMode) override;
+	virtual ERiseMatchEvent GetDependentEvents() const override;
+	virtual ERiseMatchConditionResult Evaluate(const ARisePlayerState* Player) const override;
+	virtual FString GetResultReason() const override;
+	virtual void GetPreloadClasses(TArray<FSoftObjectPath>& OutClassPaths) const override;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "RiseActorPoolSubsystem.generated.h"
+
+/**
+ * The inactive actors of a single pooled class.
+ */
+USTRUCT()
+struct FRiseActorPool
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The actors waiting to be reused. */
+	UPROPERTY()
+	TArray<AActor*> InactiveActors;
+
+	/** Whether each inactive actor was ticking when it was released, parallel to InactiveActors. */
+	TBitArray<> InactiveActorsTickEnabled;
+
+	/** The maximum number of inactive actors to keep. Released actors beyond this are destroyed. */
+	int32 MaxPooledActors = 0;
+};
+
+/**
+ * A class to pool, as configured in the game config.
+ */
+USTRUCT()
+struct FRisePooledClass
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The class to pool. */
+	UPROPERTY()
+	TSoftClassPtr<AActor> ActorClass;
+
+	/** The maximum number of inactive actors of the class to keep. */
+	UPROPERTY()
+	int32 MaxPooledActors = 0;
+};
+
+/**
+ * Recycles actors of registered classes instead of destroying and respawning them.
+ *
+ * Classes are registered from the PooledClasses list in the game config when play begins, and can
+ * also be registered at runtime with RegisterPooledClass().
+ */
+UCLASS(config = Game)
+class RISE_API URiseActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The classes to pool in every game world. */
+	UPROPERTY(config)
+	TArray<FRisePooledClass> PooledClasses;
+
+	/** The pools of the registered classes. */
+	UPROPERTY()
+	TMap<UClass*, FRiseActorPool> Pools;
+
+public:
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Enables pooling for the specified class.
+	 * 
+	 * @param ActorClass The class to pool. Only actors of exactly this class are pooled.
+	 * @param MaxPooledActors The maximum number of inactive actors of this class to keep.
+	 */
+	void RegisterPooledClass(TSubclassOf<AActor> ActorClass, int32 MaxPooledActors);
+
+	/**
+	 * Checks whether the specified class is pooled.
+	 * 
+	 * @param ActorClass The class to check.
+	 * @return Whether actors of the specified class are pooled.
+	 */
+	bool IsPooledClass(TSubclassOf<AActor> ActorClass) const;
+
+	/**
+	 * Takes an inactive actor of the specified class out of the pool.
+	 * 
+	 * @param ActorClass The class of the actor to take.
+	 * @param SpawnTransform The transform to place the actor at.
+	 * @return The reactivated actor, or nullptr if the class is not pooled or its pool is empty.
+	 */
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform);
+
+	/**
+	 * Returns the specified actor to its pool, or destroys it if its class is not pooled or its pool is full.
+	 * 
+	 * @param Actor The actor to release.
+	 * @return Whether the actor was returned to its pool.
+	 */
+	bool ReleaseActor(AActor* Actor);
+
+	/**
+	 * Returns the number of inactive actors of the specified class.
+	 * 
+	 * @param ActorClass The pooled class.
+	 * @return The number of inactive actors of the specified class.
+	 */
+	int32 GetNumPooledActors(TSubclassOf<AActor> ActorClass) const;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "Data/RiseStructureDataTable.h"
+#include "RiseBalanceDataSubsystem.generated.h"
+
+class UDataTable;
+class UScriptStruct;
+
+/**
+ * Event called after structure data has been reloaded.
+ *
+ * @param ChangedIds The ids of the rows whose stats changed. Empty when bLayoutChanged is set.
+ * @param bLayoutChanged Whether types or levels were added or removed. Every previously resolved id is invalid and must be resolved again.
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FRiseStructureDataChangedSignature, TArrayView<const FRiseStructureDataId> /* ChangedIds */, bool /* bLayoutChanged */);
+
+/**
+ * Event called after the recipe data has been reloaded.
+ */
+DECLARE_MULTICAST_DELEGATE(FRiseRecipeDataChangedSignature);
+
+/**
+ * Loads the game's balance data tables and compiles them into index-addressed lookup tables.
+ *
+ * The tables can be reloaded while the game is running, either from the source CSV files with the
+ * Rise.ReloadBalanceData console command or, in the editor, whenever the data table asset changes.
+ * The source files are staged loose with packaged builds, so a running server can be rebalanced too.
+ * Reloads are diffed against the current data and listeners are told which rows changed in one batch.
+ */
+UCLASS(config = Game)
+class RISE_API URiseBalanceDataSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The data table containing the stats of every structure type and level. */
+	UPROPERTY(config)
+	TSoftObjectPtr<UDataTable> StructureDataTable;
+
+	/** The source file of the structure data, relative to the project directory. Used when reloading. */
+	UPROPERTY(config)
+	FString StructureDataSourceFile;
+
+	/** The loaded structure data table. */
+	UPROPERTY()
+	UDataTable* LoadedStructureDataTable;
+
+	/** The compiled structure data. */
+	FRiseStructureDataTable StructureData;
+
+	/** The data table containing the production recipes. If not set, the recipes are read from RecipeDataSourceFile. */
+	UPROPERTY(config)
+	TSoftObjectPtr<UDataTable> RecipeDataTable;
+
+	/** The source file of the recipe data, relative to the project directory. Used when reloading and when no table is set. */
+	UPROPERTY(config)
+	FString RecipeDataSourceFile;
+
+	/** The loaded recipe data table. */
+	UPROPERTY()
+	UDataTable* LoadedRecipeDataTable;
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the compiled structure data.
+	 *
+	 * @return The compiled structure data.
+	 */
+	const FRiseStructureDataTable& GetStructureData() const;
+
+	/**
+	 * Gets the recipe data table.
+	 *
+	 * @return The recipe data table, or nullptr if none is configured.
+	 *
+	 * @note Recipes refer to resources by type, so they are compiled by the production subsystem once the resource ids are known.
+	 */
+	const UDataTable* GetRecipeDataTable() const;
+
+	/**
+	 * Event called after structure data has been reloaded. Runtime instances caching structure
+	 * stats should refresh the stats of the changed rows.
+	 */
+	FRiseStructureDataChangedSignature OnStructureDataChanged;
+
+	/**
+	 * Event called after the recipe data has been reloaded. Recipes should be compiled again from GetRecipeDataTable().
+	 */
+	FRiseRecipeDataChangedSignature OnRecipeDataChanged;
+
+	/**
+	 * Reloads the balance data from the source files.
+	 *
+	 * @return Whether every table was reloaded.
+	 */
+	bool ReloadBalanceData();
+
+	/**
+	 * Reloads the structure data from a CSV file.
+	 *
+	 * @param Filename The CSV file to read.
+	 * @return Whether the structure data was reloaded.
+	 */
+	bool ReloadStructureData(const FString& Filename);
+
+	/**
+	 * Reloads the recipe data from a CSV file.
+	 *
+	 * @param Filename The CSV file to read.
+	 * @return Whether the recipe data was reloaded.
+	 */
+	bool ReloadRecipeData(const FString& Filename);
+
+private:
+
+	/**
+	 * Reads a CSV file into a new transient data table. The first column holds the row names and the
+	 * header row names the property of each remaining column.
+	 *
+	 * @param Filename The CSV file to read.
+	 * @param RowStruct The row struct of the table.
+	 * @return The data table, or nullptr if no rows could be read.
+	 *
+	 * @note The data table's own CSV import is editor-only, so this parses the file itself and works in every build.
+	 */
+	static UDataTable* LoadDataTableFromCSV(const FString& Filename, UScriptStruct* RowStruct);
+
+	/**
+	 * Compiles the specified table and applies it to the current structure data, notifying listeners of any changes.
+	 */
+	void ApplyStructureData(const UDataTable* DataTable);
+
+#if WITH_EDITOR
+	void OnStructureDataTableChanged();
+#endif
+};
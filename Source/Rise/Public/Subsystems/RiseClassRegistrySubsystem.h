@@ -0,0 +1,163 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/SoftObjectPtr.h"
+
+#include "Data/RiseClassManifest.h"
+#include "RiseClassRegistrySubsystem.generated.h"
+
+struct FAssetData;
+
+/**
+ * A blueprint generated class known to the class registry.
+ */
+struct FRiseBlueprintClassEntry
+{
+	/** The name of the generated class, as used by the asset registry's class hierarchy. */
+	FName ClassName;
+
+	/** The path of the generated class. */
+	FSoftObjectPath ClassPath;
+};
+
+/**
+ * Keeps an in-memory index of blueprint classes so that content lookups by base class do not
+ * have to query the asset registry every time.
+ *
+ * The index is built once the asset registry has finished discovering assets. In the editor it
+ * is invalidated whenever blueprints are added, removed, renamed or updated and is rebuilt on
+ * the next lookup.
+ *
+ * Cooked builds load the class manifest at startup and answer lookups for the manifest's base
+ * classes from it, without touching the asset registry at all.
+ */
+UCLASS(config = Game)
+class RISE_API URiseClassRegistrySubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** Every blueprint generated class, sorted by path. */
+	TArray<FRiseBlueprintClassEntry> BlueprintClasses;
+
+	/** Caches the indices into BlueprintClasses of the classes derived from each base class. */
+	TMap<const UClass*, TArray<int32>> DerivedClassCache;
+
+	/** Whether BlueprintClasses reflects the current contents of the asset registry. */
+	bool bIndexValid;
+
+	/** Whether the asset registry has finished discovering assets. */
+	bool bReady;
+
+	/** Event called once the asset registry has finished discovering assets. */
+	FSimpleMulticastDelegate OnReady;
+
+	/** The base classes whose blueprint classes are written to the class manifest. */
+	UPROPERTY(config)
+	TArray<FSoftClassPath> ManifestBaseClasses;
+
+	/** The class manifest loaded at startup in cooked builds. */
+	FRiseClassManifest Manifest;
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the class registry.
+	 *
+	 * @return The class registry, or nullptr if the engine has not been initialized.
+	 */
+	static URiseClassRegistrySubsystem* Get();
+
+	/**
+	 * Checks whether the asset registry has finished discovering assets. Lookups made before
+	 * then only see the assets discovered so far.
+	 *
+	 * @return Whether the registry is complete.
+	 */
+	bool IsReady() const;
+
+	/**
+	 * Calls the specified delegate once the registry is complete, or immediately if it already is.
+	 *
+	 * @param Delegate The delegate to call.
+	 */
+	void CallWhenReady(FSimpleDelegate Delegate);
+
+	/**
+	 * Finds the blueprint classes derived from the specified base class.
+	 *
+	 * @param BaseClass The base class of the blueprints to find.
+	 * @param ContentPath If set, only classes within this content path or its subfolders are returned, e.g. /Game/Units.
+	 * @param ClassNameHint If set, only classes whose asset name contains this string are returned.
+	 * @param OutClassPaths The array to add the paths of the found classes to.
+	 */
+	void FindBlueprintClasses(const UClass* BaseClass, const TCHAR* ContentPath, const TCHAR* ClassNameHint, TArray<FSoftObjectPath>& OutClassPaths);
+
+	/**
+	 * Finds the blueprint classes derived from TBaseClass.
+	 *
+	 * @param ContentPath If set, only classes within this content path are returned.
+	 * @param ClassNameHint If set, only classes whose asset name contains this string are returned.
+	 * @return The found classes.
+	 */
+	template<class TBaseClass>
+	TArray<TSoftClassPtr<TBaseClass>> FindBlueprintClasses(const TCHAR* ContentPath = nullptr, const TCHAR* ClassNameHint = nullptr)
+	{
+		TArray<FSoftObjectPath> ClassPaths;
+		FindBlueprintClasses(TBaseClass::StaticClass(), ContentPath, ClassNameHint, ClassPaths);
+
+		TArray<TSoftClassPtr<TBaseClass>> Classes;
+		Classes.Reserve(ClassPaths.Num());
+		for (const FSoftObjectPath& ClassPath : ClassPaths)
+		{
+			Classes.Add(TSoftClassPtr<TBaseClass>(ClassPath));
+		}
+
+		return Classes;
+	}
+
+	/**
+	 * Gets the base classes whose blueprint classes are written to the class manifest.
+	 *
+	 * @return The manifest base classes.
+	 */
+	const TArray<FSoftClassPath>& GetManifestBaseClasses() const;
+
+	/**
+	 * Marks the index as out of date so it is rebuilt on the next lookup.
+	 */
+	void InvalidateIndex();
+
+private:
+
+	/**
+	 * Rebuilds the list of blueprint classes from the asset registry.
+	 */
+	void BuildIndex();
+
+	/**
+	 * Gets the indices of the blueprint classes derived from the specified base class.
+	 */
+	const TArray<int32>& GetDerivedClassIndices(const UClass* BaseClass);
+
+	/**
+	 * Checks whether a package is within a content path. /Game/Units contains /Game/Units/Worker
+	 * but not /Game/UnitsOld/Worker.
+	 */
+	static bool IsInContentPath(const FString& PackageName, const TCHAR* ContentPath);
+
+	/**
+	 * Called when the asset registry has finished discovering assets.
+	 */
+	void OnAssetRegistryFilesLoaded();
+
+#if WITH_EDITOR
+	void OnAssetChanged(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+#endif
+};
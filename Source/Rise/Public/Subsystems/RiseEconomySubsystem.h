@@ -0,0 +1,223 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RisePlayerMask.h"
+#include "RiseResourceTypes.h"
+#include "RiseEconomySubsystem.generated.h"
+
+class ARisePlayerState;
+class URiseResourceComponent;
+class URiseResourceRegistrySubsystem;
+struct FRiseResourceGatherResult;
+
+/**
+ * Event called once per economy tick for each player whose stockpile changed.
+ *
+ * @param PlayerIndex The index of the player.
+ * @param Deltas The resources that changed. Only resources with a non-zero change are included.
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FRiseStockpileChangedSignature, uint8 /* PlayerIndex */, TArrayView<const FRiseResourceDelta> /* Deltas */);
+
+/**
+ * Event called once per economy tick on the server, after the queued transactions have been applied.
+ */
+DECLARE_MULTICAST_DELEGATE(FRiseEconomyTickSignature);
+
+/**
+ * A queued change to a player's stockpile of a single resource.
+ */
+struct FRiseResourceTransaction
+{
+	/** The index of the player whose stockpile changes. */
+	uint8 PlayerIndex;
+
+	/** The resource that changes. */
+	FRiseResourceId ResourceId;
+
+	/** The resource amount to add to the stockpile. Negative amounts are expenses. */
+	FRiseResourceAmount Amount;
+};
+
+/**
+ * Runs the game's economy at a fixed rate, independent of the frame rate.
+ *
+ * Each player's stockpile is a dense array of amounts indexed by resource id, as assigned by the
+ * resource registry. Income and expenses are queued as transactions and applied together on the next
+ * economy tick, after which each player whose stockpile changed receives a single set of deltas.
+ */
+UCLASS(config = Game)
+class RISE_API URiseEconomySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The time in seconds between economy ticks. */
+	UPROPERTY(config)
+	float EconomyTickInterval;
+
+	/** The maximum number of economy ticks to run in a single frame when catching up after a hitch. */
+	UPROPERTY(config)
+	int32 MaxEconomyTicksPerFrame;
+
+	/** The time accumulated towards the next economy tick. */
+	float EconomyTickAccumulator;
+
+	/** The resource nodes with queued extractions, resolved on the next economy tick. */
+	UPROPERTY()
+	TArray<URiseResourceComponent*> PendingResourceNodes;
+
+	/** The stockpile of each player, indexed by player index and then by resource id. */
+	TArray<TArray<FRiseResourceAmount>> Stockpiles;
+
+	/** The transactions waiting to be applied on the next economy tick. */
+	TArray<FRiseResourceTransaction> PendingTransactions;
+
+	/** The change in each player's stockpile since the last economy tick, indexed like Stockpiles. */
+	TArray<TArray<FRiseResourceAmount>> TickDeltas;
+
+	/** The players whose stockpiles changed since the last economy tick. */
+	FRisePlayerMask ChangedPlayers;
+
+	/** The estimated bytes sent to all connections replicating resource node amounts since the replication stat was last updated. */
+	int32 ResourceReplicationBytes;
+
+	/** The time accumulated towards the next update of the replication stat. */
+	float ResourceReplicationStatTime;
+
+	/** The registry assigning the resource ids. */
+	UPROPERTY()
+	URiseResourceRegistrySubsystem* ResourceRegistry;
+
+public:
+
+	/** Event called once per economy tick for each player whose stockpile changed. */
+	FRiseStockpileChangedSignature OnStockpileChanged;
+
+	/**
+	 * Event called once per economy tick on the server, after the queued transactions have been applied
+	 * and before the deltas are published. Changes made with TrySpend() and Deposit() from this event
+	 * are included in the deltas of the same tick.
+	 */
+	FRiseEconomyTickSignature OnEconomyTick;
+
+	URiseEconomySubsystem();
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Gets the time between economy ticks.
+	 *
+	 * @return The time in seconds between economy ticks.
+	 */
+	float GetEconomyTickInterval() const;
+
+	/**
+	 * Schedules the queued extractions of the specified resource node to be resolved on the next economy tick.
+	 *
+	 * @param ResourceComponent The resource node with queued extractions.
+	 */
+	void QueueResourceNode(URiseResourceComponent* ResourceComponent);
+
+	/**
+	 * Records that a resource node sent an amount update, for the resource replication stats.
+	 *
+	 * @param Bytes The estimated size of the update sent to each client connection, in bytes.
+	 */
+	void RecordResourceReplication(int32 Bytes);
+
+	/**
+	 * Gets the amount of a resource in a player's stockpile.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ResourceId The id of the resource.
+	 * @return The resource amount the player has.
+	 */
+	FRiseResourceAmount GetResourceAmount(uint8 PlayerIndex, FRiseResourceId ResourceId) const;
+
+	/**
+	 * Gets a player's stockpile.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return The amount of each resource the player has, indexed by resource id. Empty if the player has no stockpile yet.
+	 */
+	TArrayView<const FRiseResourceAmount> GetStockpile(uint8 PlayerIndex) const;
+
+	/**
+	 * Queues a change to a player's stockpile to be applied on the next economy tick.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ResourceId The id of the resource.
+	 * @param Amount The resource amount to add. Negative amounts are expenses and never take the stockpile below zero.
+	 */
+	void QueueTransaction(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount);
+
+	/**
+	 * Immediately removes resources from a player's stockpile if the player can afford them.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ResourceId The id of the resource.
+	 * @param Amount The resource amount to remove.
+	 * @return Whether the player could afford the amount. Nothing is removed if not.
+	 *
+	 * @note Use this for purchases that must be validated straight away. The change is still reported
+	 *       with the deltas of the next economy tick.
+	 */
+	bool TrySpend(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount);
+
+	/**
+	 * Immediately adds resources to a player's stockpile.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ResourceId The id of the resource.
+	 * @param Amount The resource amount to add.
+	 *
+	 * @note Use this when the resources must be available straight away, e.g. to later stages of a production
+	 *       chain within the same economy tick. The change is still reported with the deltas of the next economy tick.
+	 */
+	void Deposit(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount);
+
+	/**
+	 * Discards a player's stockpile and queued transactions, so the next player assigned the index starts empty.
+	 *
+	 * @param PlayerIndex The index of the player that left.
+	 */
+	void ReleasePlayerIndex(uint8 PlayerIndex);
+
+protected:
+
+	/**
+	 * Advances the economy by one fixed step.
+	 */
+	virtual void EconomyTick();
+
+private:
+
+	/**
+	 * Gets the stockpile of a player, creating it if necessary.
+	 */
+	TArray<FRiseResourceAmount>& GetOrAddStockpile(uint8 PlayerIndex);
+
+	/**
+	 * Adds an amount to a player's stockpile and records the change for this tick's deltas.
+	 *
+	 * @return The amount that was actually added.
+	 */
+	FRiseResourceAmount ApplyToStockpile(uint8 PlayerIndex, FRiseResourceId ResourceId, FRiseResourceAmount Amount);
+
+	/**
+	 * Credits the owners of the gatherers of a resource node with the gathered resources.
+	 */
+	void CreditGatherers(const URiseResourceComponent* ResourceComponent, TArrayView<const FRiseResourceGatherResult> GatherResults);
+
+	/**
+	 * Sends the deltas accumulated this tick to listeners and to the affected player states.
+	 */
+	void PublishDeltas();
+};
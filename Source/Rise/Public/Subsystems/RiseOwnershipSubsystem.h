@@ -0,0 +1,238 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RiseOwnershipSubsystem.generated.h"
+
+class ARisePlayerState;
+class URiseOwnableComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FRiseOwnedActorsChangedSignature, uint8 /* PlayerIndex */);
+
+/**
+ * A dense set of the ownable components (and their actors) owned by a single player.
+ */
+USTRUCT()
+struct FRiseOwnedActorSet
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The ownable components owned by the player. */
+	UPROPERTY()
+	TArray<URiseOwnableComponent*> Components;
+
+	/**
+	 * The actors owning the components in the Components array. This array is kept
+	 * parallel to the Components array so the owned actors can be viewed without copying.
+	 */
+	UPROPERTY()
+	TArray<AActor*> Actors;
+
+	/** The number of owned actors of each tracked class, indexed by tracked class id. */
+	UPROPERTY()
+	TArray<int32> TrackedClassCounts;
+};
+
+/**
+ * The ownable components that should initially be owned by a single player.
+ */
+USTRUCT()
+struct FRiseInitialOwnerBucket
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The ownable components that should initially be owned by the player. */
+	UPROPERTY()
+	TArray<URiseOwnableComponent*> Components;
+};
+
+/**
+ * Maintains an index of ownable actors keyed by the index of the player that owns them.
+ */
+UCLASS()
+class RISE_API URiseOwnershipSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The owned actor sets, indexed by player index. */
+	UPROPERTY()
+	TArray<FRiseOwnedActorSet> PlayerSets;
+
+	/**
+	 * Components owned by a player that has not been assigned a player index yet. These are
+	 * moved into PlayerSets once the owning player receives an index.
+	 */
+	UPROPERTY()
+	FRiseOwnedActorSet UnindexedSet;
+
+	/** The classes whose owned actor counts are tracked, indexed by tracked class id. */
+	UPROPERTY()
+	TArray<UClass*> TrackedClasses;
+
+	/** Maps each tracked class to its tracked class id. */
+	TMap<const UClass*, int32> TrackedClassIds;
+
+	/** Caches the tracked class ids that each encountered actor class is a child of. */
+	TMap<const UClass*, TArray<int32>> TrackedClassMatches;
+
+	/** The ownable components that should initially be owned by each player, indexed by player index. */
+	UPROPERTY()
+	TArray<FRiseInitialOwnerBucket> InitialOwnerBuckets;
+
+public:
+
+	/**
+	 * Event called whenever an actor is added to or removed from a player's owned actors.
+	 * 
+	 * @note This is called for every individual change. Listeners should defer any expensive work.
+	 */
+	FRiseOwnedActorsChangedSignature OnOwnedActorsChanged;
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Updates the index entry of the specified ownable component to match its current owner.
+	 *
+	 * @param OwnableComponent The component whose owner has changed.
+	 */
+	void UpdateOwnable(URiseOwnableComponent* OwnableComponent);
+
+	/**
+	 * Removes the specified ownable component from the index.
+	 *
+	 * @param OwnableComponent The component to remove.
+	 */
+	void UnregisterOwnable(URiseOwnableComponent* OwnableComponent);
+
+	/**
+	 * Notifies the index that the player index of the specified player has changed.
+	 *
+	 * @param PlayerState The player whose index has changed.
+	 * @param OldPlayerIndex The previous index of the player.
+	 */
+	void NotifyPlayerIndexChanged(ARisePlayerState* PlayerState, uint8 OldPlayerIndex);
+
+	/**
+	 * Drops the owned actor set of a player index that is no longer in use, so the next player
+	 * assigned the index does not inherit the previous player's actors.
+	 *
+	 * @param PlayerIndex The index of the player that left.
+	 */
+	void ReleasePlayerIndex(uint8 PlayerIndex);
+
+	/**
+	 * Returns the actors owned by the player with the specified index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return A view of the actors owned by the player. The view is invalidated by any ownership change.
+	 */
+	TArrayView<AActor* const> GetOwnedActors(uint8 PlayerIndex) const;
+
+	/**
+	 * Returns the ownable components owned by the player with the specified index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return A view of the components owned by the player. The view is invalidated by any ownership change.
+	 */
+	TArrayView<URiseOwnableComponent* const> GetOwnedComponents(uint8 PlayerIndex) const;
+
+	/**
+	 * Returns the number of actors owned by the player with the specified index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return The number of actors owned by the player.
+	 */
+	int32 GetNumOwnedActors(uint8 PlayerIndex) const;
+
+	/**
+	 * Starts tracking the number of actors of the specified class owned by each player. Registering
+	 * a class counts the currently owned actors once; afterwards the counts are updated as ownership
+	 * changes and actors are destroyed.
+	 *
+	 * @param ActorClass The class to track. Actors of child classes are included in the count.
+	 * @return The tracked class id of the class, or INDEX_NONE if the class is invalid.
+	 *
+	 * @note Registering a class that is already tracked is cheap and returns the existing id.
+	 */
+	int32 RegisterTrackedClass(TSubclassOf<AActor> ActorClass);
+
+	/**
+	 * Returns the number of actors of the specified tracked class owned by the player with the specified index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ActorClass The tracked class to count.
+	 * @return The number of actors of the specified class owned by the player.
+	 *
+	 * @note The class must have been registered with RegisterTrackedClass(), otherwise this returns 0.
+	 */
+	int32 GetNumOwnedActorsOfClass(uint8 PlayerIndex, TSubclassOf<AActor> ActorClass) const;
+
+	/**
+	 * Adds the specified ownable component to the bucket of its initial owner.
+	 *
+	 * @param OwnableComponent The component to add. Components without an initial owner are ignored.
+	 */
+	void RegisterInitialOwnable(URiseOwnableComponent* OwnableComponent);
+
+	/**
+	 * Removes the specified ownable component from the bucket of its initial owner.
+	 *
+	 * @param OwnableComponent The component to remove.
+	 */
+	void UnregisterInitialOwnable(URiseOwnableComponent* OwnableComponent);
+
+	/**
+	 * Returns the ownable components that should initially be owned by the player with the specified index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return A view of the components. The view is invalidated when components are loaded or unloaded.
+	 */
+	TArrayView<URiseOwnableComponent* const> GetInitiallyOwnedComponents(uint8 PlayerIndex) const;
+
+private:
+
+	/**
+	 * Gets the set for the specified player index, creating it if necessary.
+	 *
+	 * @param PlayerIndex The index of the player. PLAYER_INDEX_NONE returns the unindexed set.
+	 * @return The set for the specified player index.
+	 */
+	FRiseOwnedActorSet& GetOrAddSet(uint8 PlayerIndex);
+
+	/**
+	 * Gets the set for the specified player index.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @return The set for the specified player index, or nullptr if it does not exist. Always nullptr for
+	 * PLAYER_INDEX_NONE, as the unindexed set mixes players together.
+	 */
+	const FRiseOwnedActorSet* FindSet(uint8 PlayerIndex) const;
+
+	/**
+	 * Adds the specified component to the set for the specified player index.
+	 */
+	void AddToSet(URiseOwnableComponent* OwnableComponent, uint8 PlayerIndex);
+
+	/**
+	 * Removes the specified component from the set it is currently registered in.
+	 */
+	void RemoveFromSet(URiseOwnableComponent* OwnableComponent);
+
+	/**
+	 * Adjusts the tracked class counts of the specified set for an actor of the specified class.
+	 */
+	void UpdateTrackedClassCounts(FRiseOwnedActorSet& Set, const AActor* Actor, int32 Delta);
+
+	/**
+	 * Gets the tracked class ids that the specified class is a child of.
+	 */
+	const TArray<int32>& GetTrackedClassMatches(const UClass* ActorClass);
+};
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RiseResourceTypes.h"
+#include "Data/RiseRecipeGraph.h"
+#include "RiseProductionSubsystem.generated.h"
+
+class URiseEconomySubsystem;
+
+/**
+ * What limits a player's throughput of a resource.
+ */
+enum class ERiseThroughputLimit : uint8
+{
+	/** The resource is not produced by any recipe and can only be gathered. */
+	Gathered,
+
+	/** The player has no producers of the limiting resource. */
+	NoProducers,
+
+	/** The producers of the resource have all the inputs they need. More producers are required. */
+	ProducerCapacity,
+
+	/** An input is produced more slowly than it is consumed. More producers of the limiting resource are required. */
+	InputCapacity,
+
+	/** The producers ran out of an input that can only be gathered. */
+	InputStock,
+};
+
+/**
+ * The result of a throughput query.
+ */
+struct FRiseThroughputReport
+{
+	/** The resource that was queried. */
+	FRiseResourceId ResourceId = RISE_RESOURCE_ID_NONE;
+
+	/** What limits the throughput. */
+	ERiseThroughputLimit Limit = ERiseThroughputLimit::NoProducers;
+
+	/** The resource at the bottleneck. This is the queried resource unless an input limits it. */
+	FRiseResourceId LimitingResource = RISE_RESOURCE_ID_NONE;
+
+	/** The units per minute of the queried resource the player's producers make when fully supplied. */
+	float SupplyPerMinute = 0.f;
+
+	/** The units per minute of the queried resource the player's producers consume when fully supplied. */
+	float DemandPerMinute = 0.f;
+
+	/** The resources from the queried resource up the production chain to the limiting resource. */
+	TArray<FRiseResourceId, TInlineAllocator<4>> Chain;
+};
+
+/**
+ * The producers of a single recipe. The arrays are parallel and indexed by slot.
+ */
+struct FRiseRecipeProducers
+{
+	/** The id of each producer. */
+	TArray<int32> ProducerIds;
+
+	/** The index of the player owning each producer. */
+	TArray<uint8> PlayerIndices;
+
+	/** The efficiency of each producer, where RISE_RESOURCE_AMOUNT_ONE is full speed. */
+	TArray<FRiseResourceAmount> Efficiencies;
+
+	/** The progress of each producer through its current cycle, in economy ticks scaled by RISE_RESOURCE_AMOUNT_ONE. */
+	TArray<int32> Progress;
+};
+
+/**
+ * Where a producer is stored.
+ */
+struct FRiseProducerLocation
+{
+	/** The index of the recipe the producer runs, or INDEX_NONE if the producer has been stopped. */
+	int32 RecipeIndex = INDEX_NONE;
+
+	/** The slot of the producer within the producers of the recipe. */
+	int32 Slot = INDEX_NONE;
+};
+
+/**
+ * The production capacity of a single player.
+ *
+ * Rates are resource amounts per economy tick with RISE_RESOURCE_AMOUNT_FRACTION_BITS additional
+ * fraction bits, so slow producers still contribute.
+ */
+struct FRisePlayerProduction
+{
+	/** The rate at which the player's producers make each resource when fully supplied, indexed by resource id. */
+	TArray<int64> SupplyRates;
+
+	/** The rate at which the player's producers consume each resource when fully supplied, indexed by resource id. */
+	TArray<int64> DemandRates;
+
+	/** The number of producers of each recipe, indexed by recipe index. */
+	TArray<int32> NumProducers;
+
+	/** The input that stopped cycles of each recipe from running on its last evaluation, indexed by recipe index. */
+	TArray<FRiseResourceId> StarvedInputs;
+};
+
+/**
+ * Runs the game's production chains, e.g. Sticks -> Logs -> Lumber.
+ *
+ * Recipes are compiled into a graph over resource ids when play begins and again whenever the recipe
+ * data is reloaded, keeping the producers of recipes that still exist. Producers register with the
+ * recipe they run and are stored per recipe, and every economy tick the recipes are evaluated in
+ * topological order in a single batched pass: each player's due cycles are counted, capped by the
+ * inputs in the player's stockpile, and resolved with one spend and one deposit per ingredient, so
+ * each stage can use what the previous stages made in the same tick.
+ *
+ * Each player's supply and demand capacity is kept up to date as producers are added and removed,
+ * so GetThroughputLimit() only walks the production chain and never the producers.
+ */
+UCLASS()
+class RISE_API URiseProductionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The compiled recipes. */
+	FRiseRecipeGraph RecipeGraph;
+
+	/** The producers of each recipe, indexed by recipe index. */
+	TArray<FRiseRecipeProducers> RecipeProducers;
+
+	/** The location of each producer, indexed by producer id. */
+	TArray<FRiseProducerLocation> ProducerLocations;
+
+	/**
+	 * Whether each producer id is held by an owner, indexed by producer id. Stopped producers keep their
+	 * id until they are unregistered, so a stale id can never remove a producer that reused it.
+	 */
+	TBitArray<> AllocatedProducerIds;
+
+	/** The producer ids that can be reused. */
+	TArray<int32> FreeProducerIds;
+
+	/** The production capacity of each player, indexed by player index. */
+	TArray<FRisePlayerProduction> PlayerProduction;
+
+	/** The number of cycles due for each player while evaluating a recipe. Kept to avoid reallocating every tick. */
+	TArray<int32> DueCycles;
+
+	/** The economy the producers take from and give to. */
+	UPROPERTY()
+	URiseEconomySubsystem* EconomySubsystem;
+
+	/** The handle of the economy tick callback. */
+	FDelegateHandle EconomyTickHandle;
+
+	/** The handle of the recipe data reload callback. */
+	FDelegateHandle RecipeDataChangedHandle;
+
+public:
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the compiled recipes.
+	 *
+	 * @return The compiled recipes.
+	 */
+	const FRiseRecipeGraph& GetRecipeGraph() const;
+
+	/**
+	 * Adds a producer running the specified recipe for a player.
+	 *
+	 * @param PlayerIndex The index of the player owning the producer.
+	 * @param RecipeName The name of the recipe's data table row.
+	 * @param Efficiency The speed of the producer, where RISE_RESOURCE_AMOUNT_ONE is full speed.
+	 * @return The id of the producer, or INDEX_NONE if the recipe is unknown.
+	 *
+	 * @note Producers only run on the server.
+	 */
+	int32 RegisterProducer(uint8 PlayerIndex, FName RecipeName, FRiseResourceAmount Efficiency = RISE_RESOURCE_AMOUNT_ONE);
+
+	/**
+	 * Removes a producer. Progress through its current cycle is lost.
+	 *
+	 * @param ProducerId The id returned by RegisterProducer().
+	 */
+	void UnregisterProducer(int32 ProducerId);
+
+	/**
+	 * Changes the speed of a producer, e.g. when its workers change.
+	 *
+	 * @param ProducerId The id returned by RegisterProducer().
+	 * @param Efficiency The speed of the producer, where RISE_RESOURCE_AMOUNT_ONE is full speed.
+	 */
+	void SetProducerEfficiency(int32 ProducerId, FRiseResourceAmount Efficiency);
+
+	/**
+	 * Stops every producer of a player that left and discards the player's production, so the next
+	 * player assigned the index does not inherit them. The producer ids stay valid to unregister.
+	 *
+	 * @param PlayerIndex The index of the player that left.
+	 */
+	void ReleasePlayerIndex(uint8 PlayerIndex);
+
+	/**
+	 * Finds what limits a player's throughput of a resource, following starved or undersupplied inputs
+	 * up the production chain to the bottleneck.
+	 *
+	 * @param PlayerIndex The index of the player.
+	 * @param ResourceId The id of the resource.
+	 * @return The report.
+	 */
+	FRiseThroughputReport GetThroughputLimit(uint8 PlayerIndex, FRiseResourceId ResourceId) const;
+
+private:
+
+	/**
+	 * Compiles the recipe data, keeping the producers of recipes that still exist.
+	 */
+	void CompileRecipes();
+
+	/**
+	 * Adds a producer with an allocated id to the producers of a recipe.
+	 */
+	void AddProducer(int32 ProducerId, int32 RecipeIndex, uint8 PlayerIndex, FRiseResourceAmount Efficiency, int32 Progress);
+
+	/**
+	 * Removes a producer from the producers of its recipe, leaving its id allocated.
+	 */
+	void RemoveProducer(int32 ProducerId);
+
+	/**
+	 * Gets the production of a player, creating it if necessary.
+	 */
+	FRisePlayerProduction& GetOrAddPlayerProduction(uint8 PlayerIndex);
+
+	/**
+	 * Adds or removes a producer's contribution to its player's supply and demand rates.
+	 */
+	void AdjustRates(uint8 PlayerIndex, int32 RecipeIndex, FRiseResourceAmount Efficiency, int32 Sign);
+
+	/**
+	 * Converts a rate to units per minute.
+	 */
+	float RateToUnitsPerMinute(int64 Rate) const;
+
+	/**
+	 * Runs every producer for one economy tick.
+	 */
+	void OnEconomyTick();
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RiseResourceTypes.h"
+#include "RiseResourceDensitySubsystem.generated.h"
+
+/**
+ * The density of the resource nodes of a single resource type, stored as a two-dimensional Fenwick tree.
+ */
+struct FRiseResourceDensityGrid
+{
+	/**
+	 * The Fenwick tree of node counts, indexed by Y * (Width + 1) + X with one-based cell coordinates.
+	 * The first row and column are unused.
+	 */
+	TArray<int32> Tree;
+};
+
+/**
+ * Maintains a coarse density map of the resource nodes in the world, partitioned by resource type.
+ *
+ * Each resource type has a grid of node counts covering the playable area, stored as a Fenwick
+ * tree. Adding or removing a node and counting the nodes below and left of any point both take
+ * O(log Width * log Height), so the estimated number of nodes under any box or radius is cheap
+ * enough for a building placement preview to evaluate every frame, and nodes changing anywhere
+ * in the world never cause a rebuild. The map follows the resource node index, so depleted and
+ * replanted nodes update it automatically.
+ *
+ * @note Nodes are assumed to be spread evenly within their cell. Use the resource node index for
+ * exact counts.
+ */
+UCLASS(config = Game)
+class RISE_API URiseResourceDensitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The size in world units of a density cell. */
+	UPROPERTY(config)
+	float DensityCellSize;
+
+	/** Half the size of the area covered when the level has no camera bounds volume. */
+	UPROPERTY(config)
+	float DefaultHalfExtent;
+
+	/** The world location of the corner of the first cell. */
+	FVector2D Origin;
+
+	/** The number of cells along the X axis. */
+	int32 Width;
+
+	/** The number of cells along the Y axis. */
+	int32 Height;
+
+	/** The density grid of each resource type, indexed by resource id. Grids are allocated on first use. */
+	TArray<FRiseResourceDensityGrid> Grids;
+
+	/** The handle of the binding to the resource node index. */
+	FDelegateHandle ResourceNodesChangedHandle;
+
+public:
+
+	URiseResourceDensitySubsystem();
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * Estimates the number of resource nodes of the specified type within a box.
+	 *
+	 * @param ResourceId The resource type to count.
+	 * @param Box The box to count within, on the XY plane. A building footprint, for example.
+	 * @return The estimated number of nodes within the box.
+	 */
+	float EstimateResourceNodesInBox(FRiseResourceId ResourceId, const FBox2D& Box) const;
+
+	/**
+	 * Estimates the number of resource nodes of the specified type within a radius.
+	 *
+	 * @param ResourceId The resource type to count.
+	 * @param Location The center of the radius.
+	 * @param Radius The radius to count within.
+	 * @return The estimated number of nodes within the radius.
+	 *
+	 * @note The circle is approximated by the square of equal area.
+	 */
+	float EstimateResourceNodesInRadius(FRiseResourceId ResourceId, const FVector& Location, float Radius) const;
+
+	/**
+	 * Gets the size in world units of a density cell.
+	 *
+	 * @return The size of a density cell.
+	 */
+	float GetDensityCellSize() const;
+
+private:
+
+	/**
+	 * Sizes the density grids to cover the playable area of the world.
+	 */
+	void InitializeBounds(UWorld& InWorld);
+
+	/**
+	 * Adds to the node count of the cell containing the specified location.
+	 */
+	void OnResourceNodesChanged(FRiseResourceId ResourceId, const FVector& Location, int32 Delta);
+
+	/**
+	 * Counts the nodes in all the cells below and left of the specified lattice point.
+	 */
+	int32 GetSummedCount(const FRiseResourceDensityGrid& Grid, int32 X, int32 Y) const;
+
+	/**
+	 * Samples the summed counts of the specified grid at a location in cell units, interpolating
+	 * between lattice points.
+	 */
+	float SampleSummedCounts(const FRiseResourceDensityGrid& Grid, float CellX, float CellY) const;
+};
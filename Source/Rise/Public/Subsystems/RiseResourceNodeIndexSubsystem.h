@@ -0,0 +1,241 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RiseResourceTypes.h"
+#include "RiseResourceNodeIndexSubsystem.generated.h"
+
+class ARiseResourceField;
+class URiseResourceComponent;
+
+/**
+ * Event called whenever a resource node is added to or removed from the resource node index.
+ *
+ * @param ResourceId The resource type of the node.
+ * @param Location The location of the node.
+ * @param Delta 1 if the node was added, -1 if it was removed.
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FRiseResourceNodesChangedSignature, FRiseResourceId /* ResourceId */, const FVector& /* Location */, int32 /* Delta */);
+
+/**
+ * The resource nodes of a single resource type within one grid cell.
+ */
+USTRUCT()
+struct FRiseResourceNodeCell
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The resource nodes in the cell, or nullptr for nodes that are unpromoted instances of a resource field. */
+	UPROPERTY()
+	TArray<URiseResourceComponent*> Nodes;
+
+	/** The resource field of each unpromoted field node in the Nodes array, or nullptr. Kept parallel to the Nodes array. */
+	UPROPERTY()
+	TArray<ARiseResourceField*> Fields;
+
+	/** The instance index of each unpromoted field node in the Nodes array, or INDEX_NONE. Kept parallel to the Nodes array. */
+	UPROPERTY()
+	TArray<int32> FieldInstances;
+
+	/**
+	 * The location of each node in the Nodes array. This array is kept parallel to the Nodes array
+	 * so queries can test distances without touching the nodes themselves.
+	 */
+	UPROPERTY()
+	TArray<FVector> Locations;
+};
+
+/**
+ * A sparse grid of the resource nodes of a single resource type.
+ */
+USTRUCT()
+struct FRiseResourceNodeGrid
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** The occupied cells of the grid. Cells are removed once they are empty. */
+	UPROPERTY()
+	TMap<FIntPoint, FRiseResourceNodeCell> Cells;
+
+	/** The smallest cell coordinates that have ever been occupied. */
+	FIntPoint MinCell = FIntPoint(MAX_int32, MAX_int32);
+
+	/** The largest cell coordinates that have ever been occupied. */
+	FIntPoint MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+	/** The number of resource nodes in the grid. */
+	int32 NumNodes = 0;
+};
+
+/**
+ * Maintains a spatial index of the resource nodes in the world, partitioned by resource type.
+ *
+ * Each resource type has its own sparse grid on the XY plane, so gatherers looking for the nearest
+ * node of a type never test nodes of any other type. Nodes register when play begins and
+ * unregister when they are depleted, released to a pool or removed from the world. The untouched
+ * nodes of resource fields are indexed per instance, and promoted when a search returns them.
+ *
+ * @note Resource nodes are assumed not to move while registered.
+ */
+UCLASS(config = Game)
+class RISE_API URiseResourceNodeIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The size in world units of a grid cell. Ideally about the radius of a typical query. */
+	UPROPERTY(config)
+	float CellSize;
+
+	/** The grid of each resource type, indexed by resource id. */
+	UPROPERTY()
+	TArray<FRiseResourceNodeGrid> Grids;
+
+public:
+
+	/** Event called whenever a resource node is added to or removed from the index. */
+	FRiseResourceNodesChangedSignature OnResourceNodesChanged;
+
+	URiseResourceNodeIndexSubsystem();
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Adds the specified resource node to the index at its current location.
+	 *
+	 * @param ResourceComponent The resource node to add. Nodes without a resource id are ignored.
+	 */
+	void RegisterResourceNode(URiseResourceComponent* ResourceComponent);
+
+	/**
+	 * Removes the specified resource node from the index.
+	 *
+	 * @param ResourceComponent The resource node to remove.
+	 */
+	void UnregisterResourceNode(URiseResourceComponent* ResourceComponent);
+
+	/**
+	 * Adds an unpromoted node of a resource field to the index.
+	 *
+	 * @param ResourceField The field containing the node.
+	 * @param InstanceIndex The instance index of the node.
+	 * @param ResourceId The resource type of the node.
+	 * @param Location The location of the node.
+	 */
+	void RegisterFieldInstance(ARiseResourceField* ResourceField, int32 InstanceIndex, FRiseResourceId ResourceId, const FVector& Location);
+
+	/**
+	 * Removes an unpromoted node of a resource field from the index.
+	 *
+	 * @param ResourceField The field containing the node.
+	 * @param InstanceIndex The instance index of the node.
+	 */
+	void UnregisterFieldInstance(ARiseResourceField* ResourceField, int32 InstanceIndex);
+
+	/**
+	 * Finds the resource nodes of the specified type nearest to a location.
+	 *
+	 * @param ResourceId The resource type to search for.
+	 * @param Location The location to search from.
+	 * @param MaxResults The maximum number of nodes to find.
+	 * @param MaxDistance The maximum distance of a node from the location, or 0 to search the whole world.
+	 * @param OutResourceNodes Filled with the nodes found, nearest first.
+	 *
+	 * @note Resource field nodes that are found are promoted. On clients, where they cannot be, they are left out.
+	 */
+	void FindNearestResourceNodes(FRiseResourceId ResourceId, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<URiseResourceComponent*>& OutResourceNodes);
+
+	/**
+	 * Finds the resource nodes of any of the specified types nearest to a location.
+	 *
+	 * @param Filter The resource types to search for.
+	 * @param Location The location to search from.
+	 * @param MaxResults The maximum number of nodes to find.
+	 * @param MaxDistance The maximum distance of a node from the location, or 0 to search the whole world.
+	 * @param OutResourceNodes Filled with the nodes found, nearest first.
+	 *
+	 * @note Resource field nodes that are found are promoted. On clients, where they cannot be, they are left out.
+	 */
+	void FindNearestResourceNodes(const FRiseResourceFilter& Filter, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<URiseResourceComponent*>& OutResourceNodes);
+
+	/**
+	 * Finds the resource node of the specified type nearest to a location.
+	 *
+	 * @param ResourceId The resource type to search for.
+	 * @param Location The location to search from.
+	 * @param MaxDistance The maximum distance of the node from the location, or 0 to search the whole world.
+	 * @return The nearest node, or nullptr if there is none.
+	 *
+	 * @note A resource field node that is found is promoted.
+	 */
+	URiseResourceComponent* FindNearestResourceNode(FRiseResourceId ResourceId, const FVector& Location, float MaxDistance = 0.f);
+
+	/**
+	 * Counts the resource nodes of the specified type within a radius.
+	 *
+	 * @param ResourceId The resource type to count.
+	 * @param Location The center of the radius.
+	 * @param Radius The radius to count within.
+	 * @return The number of nodes within the radius.
+	 */
+	int32 CountResourceNodesInRadius(FRiseResourceId ResourceId, const FVector& Location, float Radius) const;
+
+	/**
+	 * Gets the number of registered resource nodes of the specified type.
+	 *
+	 * @param ResourceId The resource type.
+	 * @return The number of nodes.
+	 */
+	int32 GetNumResourceNodes(FRiseResourceId ResourceId) const;
+
+private:
+
+	/** A node found by a nearest node search. */
+	struct FNearestCandidate
+	{
+		float DistanceSquared;
+		URiseResourceComponent* Node;
+		ARiseResourceField* Field;
+		int32 FieldInstance;
+	};
+
+	/**
+	 * Gets the grid cell containing the specified location.
+	 */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/**
+	 * Adds an entry to the grid of the specified resource type.
+	 *
+	 * @return The slot of the entry within its cell.
+	 */
+	int32 AddEntry(FRiseResourceId ResourceId, const FVector& Location, const FIntPoint& CellCoordinates, URiseResourceComponent* ResourceComponent, ARiseResourceField* ResourceField, int32 FieldInstance);
+
+	/**
+	 * Removes an entry from the grid of the specified resource type, swapping the last entry of the cell into its slot.
+	 */
+	void RemoveEntry(FRiseResourceId ResourceId, const FIntPoint& CellCoordinates, int32 Slot);
+
+	/**
+	 * Resolves the candidates found by a search to resource components, promoting resource field nodes.
+	 */
+	static void ResolveCandidates(TArrayView<const FNearestCandidate> Candidates, TArray<URiseResourceComponent*>& OutResourceNodes);
+
+	/**
+	 * Searches the specified grids for the nodes nearest to a location, ring by ring outwards from the
+	 * cell containing it, until no unvisited cell can contain a closer node.
+	 */
+	void FindNearestInGrids(TArrayView<const FRiseResourceNodeGrid* const> SearchGrids, const FVector& Location, int32 MaxResults, float MaxDistance, TArray<FNearestCandidate, TInlineAllocator<16>>& OutCandidates) const;
+
+	/**
+	 * Tests the nodes of a single cell against the best candidates found so far.
+	 */
+	static void GatherCandidates(const FRiseResourceNodeCell& Cell, const FVector& Location, int32 MaxResults, float MaxDistanceSquared, TArray<FNearestCandidate, TInlineAllocator<16>>& Candidates);
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Templates/SubclassOf.h"
+
+#include "RiseResourceTypes.h"
+#include "RiseResourceRegistrySubsystem.generated.h"
+
+class URiseResource;
+
+/**
+ * Assigns every resource type a dense id at startup.
+ *
+ * Ids are assigned in class path order, so the server and its clients agree on them as long as
+ * they run the same content. Player states replicate the server's GetChecksum() so clients can verify this.
+ */
+UCLASS()
+class RISE_API URiseResourceRegistrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** Every resource type, indexed by resource id. */
+	UPROPERTY()
+	TArray<TSubclassOf<URiseResource>> ResourceTypes;
+
+	/** Maps each resource type to its resource id. */
+	TMap<const UClass*, FRiseResourceId> ResourceIds;
+
+	/** The tags of each resource type, indexed by resource id. */
+	TArray<FGameplayTagContainer> ResourceTags;
+
+	/** Caches the filter of every resource type with each tag. */
+	TMap<FGameplayTag, FRiseResourceFilter> TagFilters;
+
+	/** A checksum of the resource types and their order. */
+	uint32 Checksum;
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the resource registry of the game instance the specified object belongs to.
+	 *
+	 * @param WorldContextObject An object in the world.
+	 * @return The resource registry, or nullptr if there is no game instance.
+	 */
+	static URiseResourceRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Gets the number of resource types.
+	 *
+	 * @return The number of resource types. Resource ids range from 0 to this number.
+	 */
+	int32 GetNumResourceTypes() const;
+
+	/**
+	 * Gets the id of the specified resource type.
+	 *
+	 * @param ResourceType The resource type.
+	 * @return The id of the resource type, or RISE_RESOURCE_ID_NONE if the type is unknown.
+	 */
+	FRiseResourceId GetResourceId(TSubclassOf<URiseResource> ResourceType) const;
+
+	/**
+	 * Gets the resource type with the specified id.
+	 *
+	 * @param ResourceId The id of the resource type.
+	 * @return The resource type, or nullptr if the id is invalid.
+	 */
+	TSubclassOf<URiseResource> GetResourceType(FRiseResourceId ResourceId) const;
+
+	/**
+	 * Gets the tags of the resource type with the specified id.
+	 *
+	 * @param ResourceId The id of the resource type.
+	 * @return The tags of the resource type.
+	 */
+	const FGameplayTagContainer& GetResourceTags(FRiseResourceId ResourceId) const;
+
+	/**
+	 * Builds a filter of the resource types matching the specified tags.
+	 *
+	 * @param Tags The tags to match.
+	 * @param bMatchAll Whether a resource type must have every tag, rather than any of them.
+	 * @return The matching resource types.
+	 */
+	FRiseResourceFilter MakeFilter(const FGameplayTagContainer& Tags, bool bMatchAll = false) const;
+
+	/**
+	 * Gets the filter of the resource types with the specified tag. Filters are built once and cached.
+	 *
+	 * @param Tag The tag to match. Child tags match as well.
+	 * @return A copy of the matching resource types, so it stays valid as the cache grows or is rebuilt.
+	 */
+	FRiseResourceFilter GetFilterForTag(FGameplayTag Tag);
+
+	/**
+	 * Gets a checksum of the resource types and their ids.
+	 *
+	 * @return The checksum. Two registries with the same checksum assign the same ids.
+	 */
+	uint32 GetChecksum() const;
+
+private:
+
+	/**
+	 * Builds the resource id table from every known resource class.
+	 */
+	void BuildResourceTypes();
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "RiseSchedulerSubsystem.generated.h"
+
+/**
+ * Identifies an event scheduled with the scheduler subsystem.
+ */
+struct RISE_API FRiseScheduledEventHandle
+{
+	/** The index of the event within the scheduler. */
+	int32 Index = INDEX_NONE;
+
+	/** The serial number of the event, used to detect handles to events that have already fired. */
+	uint32 Serial = 0;
+
+	/**
+	 * Checks whether this handle was ever assigned an event. The event may have fired since.
+	 *
+	 * @return Whether this handle was assigned an event.
+	 */
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	/**
+	 * Clears this handle.
+	 */
+	void Invalidate()
+	{
+		Index = INDEX_NONE;
+		Serial = 0;
+	}
+};
+
+/**
+ * Schedules long-running events, such as regrowth, arrivals and births, on a hierarchical timer wheel.
+ *
+ * Time advances in fixed ticks. The wheel has several levels of slots, each level covering a range
+ * of ticks 64 times longer than the one below it. Scheduling and cancelling an event are constant
+ * time no matter how many events are pending, and events only move down a level when the wheel
+ * turns past their slot. All the events of a tick fire together, after the wheel has been updated,
+ * so events may safely schedule or cancel other events.
+ */
+UCLASS(config = Game)
+class RISE_API URiseSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+
+	/** The number of bits of the tick count covered by each level of the wheel. */
+	static constexpr int32 SlotBits = 6;
+
+	/** The number of slots in each level of the wheel. */
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+
+	/** The number of levels in the wheel. */
+	static constexpr int32 NumLevels = 4;
+
+	/** A scheduled event, linked into the list of its wheel slot. */
+	struct FScheduledEvent
+	{
+		/** The delegate to execute when the event fires. */
+		FSimpleDelegate Delegate;
+
+		/** The tick on which the event fires. */
+		uint64 FireTick = 0;
+
+		/** The serial number of the event. Changes every time the entry is reused. */
+		uint32 Serial = 0;
+
+		/** The wheel slot the event is linked into, or INDEX_NONE if the entry is free. */
+		int32 Slot = INDEX_NONE;
+
+		/** The previous event in the slot, or INDEX_NONE. */
+		int32 Prev = INDEX_NONE;
+
+		/** The next event in the slot, or the next free entry. */
+		int32 Next = INDEX_NONE;
+	};
+
+	/** The time in seconds between scheduler ticks. Events fire on the first tick at or after their time. */
+	UPROPERTY(config)
+	float SchedulerTickInterval;
+
+	/** The time accumulated towards the next scheduler tick. */
+	float SchedulerTickAccumulator;
+
+	/** The last tick that was processed. */
+	uint64 CurrentTick;
+
+	/** Every event entry, scheduled or free. */
+	TArray<FScheduledEvent> Events;
+
+	/** The first free entry in Events, or INDEX_NONE. */
+	int32 FirstFreeEvent;
+
+	/** The first event in each wheel slot, indexed by Level * SlotsPerLevel + Slot. */
+	int32 SlotHeads[NumLevels * SlotsPerLevel];
+
+	/** The number of events waiting to fire. */
+	int32 NumScheduledEvents;
+
+	/** The delegates firing on the current tick. Kept to avoid reallocating every tick. */
+	TArray<FSimpleDelegate> FiringDelegates;
+
+public:
+
+	URiseSchedulerSubsystem();
+
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Schedules a delegate to be executed after a delay.
+	 *
+	 * @param Delay The delay in seconds. Rounded up to the next scheduler tick.
+	 * @param Delegate The delegate to execute.
+	 * @return A handle to the event, which can be used to cancel it.
+	 */
+	FRiseScheduledEventHandle ScheduleEvent(float Delay, FSimpleDelegate Delegate);
+
+	/**
+	 * Cancels a scheduled event. Does nothing if the event has already fired or been cancelled.
+	 *
+	 * @param Handle The handle of the event. Invalidated by this call.
+	 * @return Whether an event was cancelled.
+	 */
+	bool CancelEvent(FRiseScheduledEventHandle& Handle);
+
+	/**
+	 * Checks whether an event is still waiting to fire.
+	 *
+	 * @param Handle The handle of the event.
+	 * @return Whether the event is waiting to fire.
+	 */
+	bool IsEventScheduled(const FRiseScheduledEventHandle& Handle) const;
+
+	/**
+	 * Gets the time until an event fires.
+	 *
+	 * @param Handle The handle of the event.
+	 * @return The time in seconds until the event fires, or -1 if it is not scheduled.
+	 */
+	float GetTimeRemaining(const FRiseScheduledEventHandle& Handle) const;
+
+	/**
+	 * Gets the number of events waiting to fire.
+	 *
+	 * @return The number of events waiting to fire.
+	 */
+	int32 GetNumScheduledEvents() const;
+
+private:
+
+	/**
+	 * Advances the wheel by a single tick and fires every event due on it.
+	 */
+	void SchedulerTick();
+
+	/**
+	 * Links an event into the slot matching its fire tick.
+	 */
+	void LinkEvent(int32 EventIndex);
+
+	/**
+	 * Unlinks an event from its slot.
+	 */
+	void UnlinkEvent(int32 EventIndex);
+
+	/**
+	 * Returns an event entry to the free list.
+	 */
+	void FreeEvent(int32 EventIndex);
+
+	/**
+	 * Moves every event in a slot down to the slots matching their fire ticks.
+	 */
+	void CascadeSlot(int32 Level, int32 Slot);
+};
@@ -10,6 +10,6 @@ public class RiseEditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.AddRange( new string[] { "Rise" } );
+		ExtraModuleNames.AddRange( new string[] { "Rise", "RiseEditor" } );
 	}
 }
@@ -0,0 +1,74 @@
+#include "Commandlets/RiseClassManifestCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+
+#include "RiseLog.h"
+#include "Data/RiseClassManifest.h"
+#include "Subsystems/RiseClassRegistrySubsystem.h"
+
+URiseClassManifestCommandlet::URiseClassManifestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 URiseClassManifestCommandlet::Main(const FString& Params)
+{
+	FString Filename = FRiseClassManifest::GetDefaultFilename();
+	FParse::Value(*Params, TEXT("Output="), Filename);
+
+	// Commandlets do not wait for the background asset discovery, so gather everything now.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	URiseClassRegistrySubsystem* ClassRegistry = URiseClassRegistrySubsystem::Get();
+	if (!ClassRegistry)
+	{
+		UE_LOG(LogRise, Error, TEXT("The class registry is not available."));
+		return 1;
+	}
+
+	ClassRegistry->InvalidateIndex();
+
+	FRiseClassManifest Manifest;
+	int32 NumClasses = 0;
+
+	for (const FSoftClassPath& BaseClassPath : ClassRegistry->GetManifestBaseClasses())
+	{
+		UClass* BaseClass = BaseClassPath.TryLoadClass<UObject>();
+		if (!BaseClass)
+		{
+			UE_LOG(LogRise, Warning, TEXT("Skipping unknown manifest base class %s."), *BaseClassPath.ToString());
+			continue;
+		}
+
+		TArray<FSoftObjectPath> ClassPaths;
+		ClassRegistry->FindBlueprintClasses(BaseClass, nullptr, nullptr, ClassPaths);
+
+		TArray<FRiseClassManifestEntry>& Entries = Manifest.ClassesByBaseClass.Add(*BaseClass->GetPathName());
+		Entries.Reserve(ClassPaths.Num());
+
+		for (const FSoftObjectPath& ClassPath : ClassPaths)
+		{
+			FRiseClassManifestEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.ClassPath = ClassPath;
+			Entry.NameHint = ClassPath.GetAssetName();
+		}
+
+		NumClasses += Entries.Num();
+
+		UE_LOG(LogRise, Display, TEXT("%s: %i classes"), *BaseClass->GetName(), Entries.Num());
+	}
+
+	if (!Manifest.SaveToFile(Filename))
+	{
+		UE_LOG(LogRise, Error, TEXT("Unable to write class manifest %s."), *Filename);
+		return 1;
+	}
+
+	UE_LOG(LogRise, Display, TEXT("Wrote %i classes to %s."), NumClasses, *Filename);
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "RiseClassManifestCommandlet.generated.h"
+
+/**
+ * Writes the class manifest used by cooked builds to look up content classes. Run this before cooking:
+ *
+ *     UnrealEditor-Cmd Rise.uproject -run=RiseClassManifest [-Output=<Filename>]
+ *
+ * The base classes to list are configured by ManifestBaseClasses on URiseClassRegistrySubsystem.
+ */
+UCLASS()
+class RISEEDITOR_API URiseClassManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	URiseClassManifestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
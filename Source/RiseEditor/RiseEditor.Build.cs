@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class RiseEditor : ModuleRules
+{
+	public RiseEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] {
+			"Core",
+			"CoreUObject",
+			"Engine",
+			"Rise"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"AssetRegistry"
+		});
+	}
+}